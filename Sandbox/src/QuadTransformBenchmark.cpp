@@ -0,0 +1,106 @@
+#include "QuadTransformBenchmark.h"
+
+#include "Random.h"
+
+#include "Sora/Core/Timer.h"
+
+#include <imgui/imgui.h>
+#include <glm/gtc/constants.hpp>
+
+QuadTransformBenchmark::QuadTransformBenchmark()
+	: Layer("QuadTransformBenchmark")
+{
+}
+
+void QuadTransformBenchmark::Run()
+{
+	const size_t count = (size_t)m_SpriteCount;
+
+	std::vector<Sora::TransformComponent> transforms(count);
+	std::vector<float> translationX(count), translationY(count), translationZ(count);
+	std::vector<float> rotation(count), scaleX(count), scaleY(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		Sora::TransformComponent& transform = transforms[i];
+		transform.Translation = { Random::Float() * 200.0f - 100.0f, Random::Float() * 200.0f - 100.0f, Random::Float() };
+		transform.Rotation = { 0.0f, 0.0f, Random::Float() * glm::two_pi<float>() - glm::pi<float>() };
+		transform.Scale = { Random::Float() * 4.0f + 0.1f, Random::Float() * 4.0f + 0.1f, 1.0f };
+
+		translationX[i] = transform.Translation.x;
+		translationY[i] = transform.Translation.y;
+		translationZ[i] = transform.Translation.z;
+		rotation[i] = transform.Rotation.z;
+		scaleX[i] = transform.Scale.x;
+		scaleY[i] = transform.Scale.y;
+	}
+
+	const glm::vec4 quadVertexPosition[4] = {
+		{ -0.5f, -0.5f, 0.0f, 1.0f },
+		{  0.5f, -0.5f, 0.0f, 1.0f },
+		{  0.5f,  0.5f, 0.0f, 1.0f },
+		{ -0.5f,  0.5f, 0.0f, 1.0f }
+	};
+
+	m_Results.clear();
+
+	std::vector<glm::vec3> reference(count * 4);
+	{
+		Sora::Timer timer;
+		for (int iteration = 0; iteration < m_Iterations; iteration++)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				glm::mat4 transform = transforms[i].GetTransform();
+				for (size_t j = 0; j < 4; j++)
+					reference[i * 4 + j] = transform * quadVertexPosition[j];
+			}
+		}
+		m_Results.push_back({ "glm", timer.ElapsedMillis() / m_Iterations, 0.0f });
+	}
+
+	Sora::Math::QuadTransformArrays quads = {
+		translationX.data(), translationY.data(), translationZ.data(),
+		rotation.data(), scaleX.data(), scaleY.data()
+	};
+
+	std::vector<glm::vec3> corners(count * 4);
+	Sora::Math::SimdLevel levels[] = { Sora::Math::SimdLevel::Scalar, Sora::Math::SimdLevel::SSE2, Sora::Math::SimdLevel::AVX2 };
+	for (Sora::Math::SimdLevel level : levels)
+	{
+		if (level > Sora::Math::GetSupportedSimdLevel())
+			continue;
+
+		Sora::Timer timer;
+		for (int iteration = 0; iteration < m_Iterations; iteration++)
+			Sora::Math::TransformQuads(quads, count, corners.data(), level);
+		float milliseconds = timer.ElapsedMillis() / m_Iterations;
+
+		float maxError = 0.0f;
+		for (size_t i = 0; i < corners.size(); i++)
+		{
+			glm::vec3 difference = glm::abs(corners[i] - reference[i]);
+			maxError = std::max(maxError, std::max(difference.x, std::max(difference.y, difference.z)));
+		}
+
+		m_Results.push_back({ Sora::Math::SimdLevelToString(level), milliseconds, maxError });
+	}
+}
+
+void QuadTransformBenchmark::OnImGuiRender()
+{
+	ImGui::Begin("Quad Transform Benchmark");
+
+	ImGui::DragInt("Sprites", &m_SpriteCount, 1000.0f, 8, 1000000);
+	ImGui::DragInt("Iterations", &m_Iterations, 1.0f, 1, 1000);
+	if (ImGui::Button("Run"))
+		Run();
+
+	ImGui::Text("Supported: %s", Sora::Math::SimdLevelToString(Sora::Math::GetSupportedSimdLevel()));
+	for (const Result& result : m_Results)
+	{
+		float speedup = m_Results[0].Milliseconds / result.Milliseconds;
+		ImGui::Text("%-8s %8.3f ms  x%.2f  max error %g", result.Name.c_str(), result.Milliseconds, speedup, result.MaxError);
+	}
+
+	ImGui::End();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Sora.h"
+#include "Sora/Math/QuadTransform.h"
+
+// Times Sora::Math::TransformQuads at each SIMD level against building TransformComponent::GetTransform() and
+// multiplying the four quad corners through glm, which is what Renderer2D does per sprite.
+class QuadTransformBenchmark : public Sora::Layer
+{
+public:
+	QuadTransformBenchmark();
+	virtual ~QuadTransformBenchmark() = default;
+
+	virtual void OnImGuiRender() override;
+private:
+	void Run();
+private:
+	struct Result
+	{
+		std::string Name;
+		float Milliseconds;
+		float MaxError;
+	};
+
+	int m_SpriteCount = 100000;
+	int m_Iterations = 20;
+	std::vector<Result> m_Results;
+};
@@ -7,6 +7,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "Sandbox2D.h"
+#include "QuadTransformBenchmark.h"
 
 class Sandbox : public Sora::Application
 {
@@ -14,6 +15,7 @@ public:
 	Sandbox()
 	{
 		PushLayer(new Sandbox2D());
+		PushLayer(new QuadTransformBenchmark());
 	}
 
 	~Sandbox()
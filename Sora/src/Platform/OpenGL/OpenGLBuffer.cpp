@@ -9,13 +9,30 @@ namespace Sora {
 	///// VertexBuffer ///////////////////////////////////////////////////////////////////
 	//////////////////////////////////////////////////////////////////////////////////////
 
-	OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size)
+	OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size, BufferUsage usage, uint32_t regionCount)
+		: m_Usage(usage)
 	{
 		SORA_PROFILE_FUNCTION();
 
 		glCreateBuffers(1, &m_RendererID);
 		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-		glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STATIC_DRAW);
+
+		if (m_Usage == BufferUsage::Stream)
+		{
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+			SORA_CORE_ASSERT(regionCount >= 2, "A stream buffer needs at least two regions!");
+			m_RegionSize = size;
+			m_RegionCount = regionCount;
+			m_RegionFences.resize(m_RegionCount, nullptr);
+			glNamedBufferStorage(m_RendererID, (GLsizeiptr)m_RegionSize * m_RegionCount, nullptr, flags);
+			m_MappedData = (uint8_t*)glMapNamedBufferRange(m_RendererID, 0, (GLsizeiptr)m_RegionSize * m_RegionCount, flags);
+			SORA_CORE_ASSERT(m_MappedData, "Failed to map stream vertex buffer!");
+		}
+		else
+		{
+			glBufferData(GL_ARRAY_BUFFER, size, nullptr, m_Usage == BufferUsage::Static ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW);
+		}
 	}
 
 	OpenGLVertexBuffer::OpenGLVertexBuffer(float* vertices, uint32_t size)
@@ -31,6 +48,15 @@ namespace Sora {
 	{
 		SORA_PROFILE_FUNCTION();
 
+		for (GLsync fence : m_RegionFences)
+		{
+			if (fence)
+				glDeleteSync(fence);
+		}
+
+		if (m_MappedData)
+			glUnmapNamedBuffer(m_RendererID);
+
 		glDeleteBuffers(1, &m_RendererID);
 	}
 
@@ -51,10 +77,61 @@ namespace Sora {
 
 	void OpenGLVertexBuffer::SetData(const void* data, uint32_t size)
 	{
+		if (m_Usage == BufferUsage::Stream)
+		{
+			SORA_CORE_ASSERT(size <= m_RegionSize, "Data does not fit in a stream buffer region!");
+			memcpy(MapRegion(), data, size);
+			return;
+		}
+
 		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
 	}
 
+	void* OpenGLVertexBuffer::MapRegion()
+	{
+		SORA_CORE_ASSERT(m_Usage == BufferUsage::Stream, "Only stream vertex buffers can be mapped!");
+
+		GLsync& fence = m_RegionFences[m_RegionIndex];
+		if (fence)
+		{
+			SORA_PROFILE_SCOPE("OpenGLVertexBuffer::MapRegion - wait");
+
+			GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+			while (result == GL_TIMEOUT_EXPIRED)
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		return m_MappedData + GetRegionOffset();
+	}
+
+	void OpenGLVertexBuffer::ReleaseRegion()
+	{
+		SORA_CORE_ASSERT(m_Usage == BufferUsage::Stream, "Only stream vertex buffers can be mapped!");
+
+		// Each held region gets a fence of its own, all of them placed after the draw that reads them.
+		for (uint32_t i = 0; i <= m_HeldRegionCount; i++)
+		{
+			uint32_t region = (m_RegionIndex + m_RegionCount - i) % m_RegionCount;
+			m_RegionFences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+
+		m_HeldRegionCount = 0;
+		m_RegionIndex = (m_RegionIndex + 1) % m_RegionCount;
+	}
+
+	void OpenGLVertexBuffer::HoldRegion()
+	{
+		SORA_CORE_ASSERT(m_Usage == BufferUsage::Stream, "Only stream vertex buffers can be mapped!");
+		SORA_CORE_ASSERT(m_HeldRegionCount + 1 < m_RegionCount, "Every other region of the stream buffer is already held!");
+
+		m_HeldRegionCount++;
+		m_RegionIndex = (m_RegionIndex + 1) % m_RegionCount;
+	}
+
 	//////////////////////////////////////////////////////////////////////////////////////
 	///// IndexBuffer ////////////////////////////////////////////////////////////////////
 	//////////////////////////////////////////////////////////////////////////////////////
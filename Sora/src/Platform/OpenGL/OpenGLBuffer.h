@@ -2,12 +2,14 @@
 
 #include "Sora/Renderer/Buffer.h"
 
+typedef struct __GLsync* GLsync;
+
 namespace Sora {
 
 	class OpenGLVertexBuffer : public VertexBuffer
 	{
 	public:
-		OpenGLVertexBuffer(uint32_t size);
+		OpenGLVertexBuffer(uint32_t size, BufferUsage usage, uint32_t regionCount);
 		OpenGLVertexBuffer(float* vertices, uint32_t size);
 		virtual ~OpenGLVertexBuffer();
 
@@ -18,9 +20,24 @@ namespace Sora {
 		virtual const BufferLayout& GetLayout() const override { return m_Layout; }
 
 		virtual void SetData(const void* data, uint32_t size) override;
+
+		virtual void* MapRegion() override;
+		virtual void ReleaseRegion() override;
+		virtual uint32_t GetRegionOffset() const override { return m_RegionIndex * m_RegionSize; }
+		virtual void HoldRegion() override;
+		virtual uint32_t GetRegionCount() const override { return m_RegionCount; }
 	private:
 		uint32_t m_RendererID;
 		BufferLayout m_Layout;
+		BufferUsage m_Usage = BufferUsage::Static;
+
+		// Stream usage
+		uint8_t* m_MappedData = nullptr;
+		uint32_t m_RegionSize = 0;
+		uint32_t m_RegionCount = 0;
+		uint32_t m_RegionIndex = 0;
+		uint32_t m_HeldRegionCount = 0;
+		std::vector<GLsync> m_RegionFences;
 	};
 
 	class OpenGLIndexBuffer : public IndexBuffer
@@ -1,6 +1,8 @@
 #include "sorapch.h"
 #include "OpenGLFramebuffer.h"
 
+#include "Sora/Renderer/Renderer.h"
+
 #include <glad/glad.h>
 
 namespace Sora {
@@ -9,71 +11,25 @@ namespace Sora {
 
 	namespace Utils {
 
-		static GLenum TextureTarget(bool multisampled)
-		{
-			return multisampled ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
-		}
-
-		static void CreateTextures(bool multisampled, uint32_t* out_id, uint32_t count)
-		{
-			glCreateTextures(TextureTarget(multisampled), count, out_id);
-		}
-
-		static void BindTexture(bool multisampled, uint32_t id)
-		{
-			glBindTexture(TextureTarget(multisampled), id);
-		}
-
-		static void AttachColorTexture(uint32_t id, int samples, GLenum internal_format, GLenum format, uint32_t width, uint32_t height, int index)
-		{
-			bool multisampled = samples > 1;
-			if (multisampled)
-			{
-				glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, samples, format, width, height, GL_FALSE);
-			}
-			else
-			{
-				glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
-
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-			}
-
-			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + index, TextureTarget(multisampled), id, 0);
-		}
-
-		static void AttachDepthTexture(uint32_t id, int samples, GLenum format, GLenum attachment_type, uint32_t width, uint32_t height)
+		static bool IsDepthFormat(FramebufferTextureFormat format)
 		{
-			bool multisampled = samples > 1;
-			if (multisampled)
-			{
-				glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, samples, format, width, height, GL_FALSE);
-			}
-			else
+			switch (format)
 			{
-				glTexStorage2D(GL_TEXTURE_2D, 1, format, width, height);
-
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+				case Sora::FramebufferTextureFormat::DEPTH24STENCIL8: return true;
 			}
 
-			glFramebufferTexture2D(GL_FRAMEBUFFER, attachment_type, TextureTarget(multisampled), id, 0);
+			return false;
 		}
 
-		static bool IsDepthFormat(FramebufferTextureFormat format)
+		static void ToGLReadFormat(FramebufferTextureFormat format, GLenum& o_Format, GLenum& o_Type)
 		{
 			switch (format)
 			{
-				case Sora::FramebufferTextureFormat::DEPTH24STENCIL8: return true;
+				case Sora::FramebufferTextureFormat::RGBA8:			o_Format = GL_RGBA; o_Type = GL_UNSIGNED_BYTE; return;
+				case Sora::FramebufferTextureFormat::RED_INTEGER:	o_Format = GL_RED_INTEGER; o_Type = GL_INT; return;
 			}
 
-			return false;
+			SORA_CORE_ASSERT(false, "Unknown framebuffer texture format!");
 		}
 
 		static GLenum ToGLFormat (FramebufferTextureFormat format)
@@ -91,7 +47,7 @@ namespace Sora {
 	}
 
 	OpenGLFramebuffer::OpenGLFramebuffer(const FramebufferSpecification& spec)
-		: mSpecification(spec)
+		: mSpecification(spec), mPool(Renderer::GetRenderTargetPool())
 	{
 		for (auto& spec : mSpecification.Attachments.Attachments)
 		{
@@ -106,84 +62,72 @@ namespace Sora {
 
 	OpenGLFramebuffer::~OpenGLFramebuffer()
 	{
+		ReleaseAttachments();
 		glDeleteFramebuffers(1, &mRendererID);
-		glDeleteTextures(mColorAttachments.size(), mColorAttachments.data());
-		glDeleteTextures(1, &mDepthAttachment);
 
-		mColorAttachments.clear();
-		mDepthAttachment = 0;
+		for (ReadbackSlot& slot : mReadbackSlots)
+		{
+			if (slot.Fence)
+				glDeleteSync(slot.Fence);
+			if (slot.BufferID)
+				glDeleteBuffers(1, &slot.BufferID);
+		}
 	}
 
 	void OpenGLFramebuffer::Invalidate()
 	{
-		if (mRendererID)
-		{
-			glDeleteFramebuffers(1, &mRendererID);
-			glDeleteTextures(mColorAttachments.size(), mColorAttachments.data());
-			glDeleteTextures(1, &mDepthAttachment);
-		}
+		SORA_PROFILE_FUNCTION();
 
-		glCreateFramebuffers(1, &mRendererID);
-		glBindFramebuffer(GL_FRAMEBUFFER, mRendererID);
-		
-		bool multisample = mSpecification.Samples > 1;
+		ReleaseAttachments();
 
-		if (mColorAttachmentSpecifications.size())
-		{
-			mColorAttachments.resize(mColorAttachmentSpecifications.size());
-			Utils::CreateTextures(multisample, mColorAttachments.data(), mColorAttachments.size());
+		mAttachmentWidth = RenderTargetPool::GetBucketSize(mSpecification.Width);
+		mAttachmentHeight = RenderTargetPool::GetBucketSize(mSpecification.Height);
 
-			for (uint32_t i = 0; i < mColorAttachments.size(); i++)
-			{
-				Utils::BindTexture(multisample, mColorAttachments[i]);
-				switch (mColorAttachmentSpecifications[i].TextureFormat)
-				{
-				case FramebufferTextureFormat::RGBA8:
-					Utils::AttachColorTexture(mColorAttachments[i], mSpecification.Samples, GL_RGBA8, GL_RGBA, mSpecification.Width, mSpecification.Height, i);
-					break;
-				case FramebufferTextureFormat::RED_INTEGER:
-					Utils::AttachColorTexture(mColorAttachments[i], mSpecification.Samples, GL_R32I, GL_RED_INTEGER, mSpecification.Width, mSpecification.Height, i);
-					break;
-				}
-			}
+		if (!mRendererID)
+			glCreateFramebuffers(1, &mRendererID);
+
+		mColorAttachments.resize(mColorAttachmentSpecifications.size());
+		for (uint32_t i = 0; i < mColorAttachments.size(); i++)
+		{
+			mColorAttachments[i] = mPool->Acquire(mColorAttachmentSpecifications[i].TextureFormat, mSpecification.Samples, mAttachmentWidth, mAttachmentHeight);
+			glNamedFramebufferTexture(mRendererID, GL_COLOR_ATTACHMENT0 + i, mColorAttachments[i], 0);
 		}
 
 		if (mDepthAttachmentSpecifications.TextureFormat != FramebufferTextureFormat::None)
 		{
-			Utils::CreateTextures(multisample, &mDepthAttachment, 1);
-			Utils::BindTexture(multisample, mDepthAttachment);
-
-			switch (mDepthAttachmentSpecifications.TextureFormat)
-			{
-			case FramebufferTextureFormat::DEPTH24STENCIL8:
-				Utils::AttachDepthTexture(mDepthAttachment, mSpecification.Samples, GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL_ATTACHMENT, mSpecification.Width, mSpecification.Height);
-				break;
-			}
+			mDepthAttachment = mPool->Acquire(mDepthAttachmentSpecifications.TextureFormat, mSpecification.Samples, mAttachmentWidth, mAttachmentHeight);
+			glNamedFramebufferTexture(mRendererID, GL_DEPTH_STENCIL_ATTACHMENT, mDepthAttachment, 0);
 		}
 
 		if (mColorAttachments.size() > 1)
 		{
 			SORA_CORE_ASSERT(mColorAttachments.size() <= 4, "");
 			GLenum buffer[4] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
-			glDrawBuffers(mColorAttachments.size(), buffer);
+			glNamedFramebufferDrawBuffers(mRendererID, (GLsizei)mColorAttachments.size(), buffer);
 		}
 		else if(mColorAttachments.empty())
 		{
-			glDrawBuffer(GL_NONE);
+			glNamedFramebufferDrawBuffer(mRendererID, GL_NONE);
 		}
 
-		SORA_CORE_ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Framebuffer is incomplete!");
+		SORA_CORE_ASSERT(glCheckNamedFramebufferStatus(mRendererID, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Framebuffer is incomplete!");
+	}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	void OpenGLFramebuffer::ReleaseAttachments()
+	{
+		for (uint32_t attachment : mColorAttachments)
+			mPool->Release(attachment);
+		mColorAttachments.clear();
+
+		if (mDepthAttachment)
+			mPool->Release(mDepthAttachment);
+		mDepthAttachment = 0;
 	}
 
 	void OpenGLFramebuffer::Bind()
 	{
 		glBindFramebuffer(GL_FRAMEBUFFER, mRendererID);
 		glViewport(0, 0, mSpecification.Width, mSpecification.Height);
-
-		int value = -1;
-		glClearTexImage(mColorAttachments[1], 0, GL_RED_INTEGER, GL_INT, &value);
 	}
 
 	void OpenGLFramebuffer::Unbind()
@@ -201,6 +145,11 @@ namespace Sora {
 
 		mSpecification.Width = width;
 		mSpecification.Height = height;
+
+		// Dragging a panel resizes every frame, most of which fit in the attachments.
+		if (width <= mAttachmentWidth && height <= mAttachmentHeight)
+			return;
+
 		Invalidate();
 	}
 
@@ -215,14 +164,118 @@ namespace Sora {
 		return pixel_data;
 	}
 
+	uint64_t OpenGLFramebuffer::RequestReadback(uint32_t attachment_index, int x, int y, uint32_t width, uint32_t height)
+	{
+		SORA_PROFILE_FUNCTION();
+		SORA_CORE_ASSERT(attachment_index < mColorAttachments.size(), "Index {0} is out of bound. There are {1} color attachment(s)", attachment_index, mColorAttachments.size());
+		SORA_CORE_ASSERT(mSpecification.Samples == 1, "Multisampled attachments cannot be read back!");
+
+		// Requests keep coming while the GPU is behind, dropping them keeps it from being waited on.
+		if (mPendingReadbackCount == ReadbackSlotCount)
+			return 0;
+
+		const int left = std::max(x, 0), bottom = std::max(y, 0);
+		const int right = std::min(x + (int)width, (int)mSpecification.Width);
+		const int top = std::min(y + (int)height, (int)mSpecification.Height);
+		if (right <= left || top <= bottom)
+			return 0;
+
+		ReadbackSlot& slot = mReadbackSlots[(mOldestReadback + mPendingReadbackCount) % ReadbackSlotCount];
+		slot.Readback.RequestID = mNextReadbackID++;
+		slot.Readback.AttachmentIndex = attachment_index;
+		slot.Readback.X = left;
+		slot.Readback.Y = bottom;
+		slot.Readback.Width = (uint32_t)(right - left);
+		slot.Readback.Height = (uint32_t)(top - bottom);
+
+		const size_t size = (size_t)slot.Readback.Width * slot.Readback.Height * sizeof(int);
+		if (size > slot.Capacity)
+		{
+			if (slot.BufferID)
+				glDeleteBuffers(1, &slot.BufferID);
+
+			slot.Capacity = std::max(size, slot.Capacity * 2);
+
+			const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glCreateBuffers(1, &slot.BufferID);
+			glNamedBufferStorage(slot.BufferID, (GLsizeiptr)slot.Capacity, nullptr, flags);
+			slot.MappedData = (const int*)glMapNamedBufferRange(slot.BufferID, 0, (GLsizeiptr)slot.Capacity, flags);
+		}
+
+		GLenum format, type;
+		Utils::ToGLReadFormat(mColorAttachmentSpecifications[attachment_index].TextureFormat, format, type);
+
+		// Reads into the buffer, so glReadPixels only queues the copy.
+		GLint previousReadFramebuffer;
+		glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, mRendererID);
+		glReadBuffer(GL_COLOR_ATTACHMENT0 + attachment_index);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.BufferID);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glReadPixels(left, bottom, (GLsizei)slot.Readback.Width, (GLsizei)slot.Readback.Height, format, type, nullptr);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFramebuffer);
+
+		slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		mPendingReadbackCount++;
+		return slot.Readback.RequestID;
+	}
+
+	bool OpenGLFramebuffer::PollReadback(FramebufferReadback& o_Readback)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		if (mPendingReadbackCount == 0)
+			return false;
+
+		ReadbackSlot& slot = mReadbackSlots[mOldestReadback];
+		if (glClientWaitSync(slot.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED)
+			return false;
+
+		glDeleteSync(slot.Fence);
+		slot.Fence = nullptr;
+
+		o_Readback.RequestID = slot.Readback.RequestID;
+		o_Readback.AttachmentIndex = slot.Readback.AttachmentIndex;
+		o_Readback.X = slot.Readback.X;
+		o_Readback.Y = slot.Readback.Y;
+		o_Readback.Width = slot.Readback.Width;
+		o_Readback.Height = slot.Readback.Height;
+		o_Readback.Pixels.assign(slot.MappedData, slot.MappedData + (size_t)slot.Readback.Width * slot.Readback.Height);
+
+		mOldestReadback = (mOldestReadback + 1) % ReadbackSlotCount;
+		mPendingReadbackCount--;
+		return true;
+	}
+
 	void OpenGLFramebuffer::ClearAttachment(uint32_t attachment_index, int value)
 	{
 		SORA_CORE_ASSERT(attachment_index < mColorAttachments.size(), "Index {0} is out of bound. There are {1} color attachment(s)", attachment_index, mColorAttachments.size());
 	
 		auto& spec = mColorAttachmentSpecifications[attachment_index];
 		
-		glClearTexImage(mColorAttachments[attachment_index], 0,
+		glClearTexSubImage(mColorAttachments[attachment_index], 0, 0, 0, 0, mSpecification.Width, mSpecification.Height, 1,
 			Utils::ToGLFormat(spec.TextureFormat), GL_INT, &value);
 	}
 
+
+	void OpenGLFramebuffer::ClearAttachment(uint32_t attachment_index, const glm::vec4& value)
+	{
+		SORA_CORE_ASSERT(attachment_index < mColorAttachments.size(), "Index {0} is out of bound. There are {1} color attachment(s)", attachment_index, mColorAttachments.size());
+		SORA_CORE_ASSERT(mColorAttachmentSpecifications[attachment_index].TextureFormat == FramebufferTextureFormat::RGBA8, "Only RGBA8 attachments are cleared to a colour!");
+
+		glClearTexSubImage(mColorAttachments[attachment_index], 0, 0, 0, 0, mSpecification.Width, mSpecification.Height, 1,
+			GL_RGBA, GL_FLOAT, &value);
+	}
+
+	void OpenGLFramebuffer::ClearDepthAttachment(float value)
+	{
+		SORA_CORE_ASSERT(mDepthAttachment, "Framebuffer has no depth attachment!");
+
+		// GL_FLOAT_32_UNSIGNED_INT_24_8_REV: the depth, then the stencil in the low 8 bits of the next 32.
+		struct { float Depth; uint32_t Stencil; } depthStencil = { value, 0 };
+		glClearTexSubImage(mDepthAttachment, 0, 0, 0, 0, mSpecification.Width, mSpecification.Height, 1,
+			GL_DEPTH_STENCIL, GL_FLOAT_32_UNSIGNED_INT_24_8_REV, &depthStencil);
+	}
+
 }
\ No newline at end of file
@@ -1,12 +1,17 @@
 #pragma once
 
 #include "Sora/Renderer/Framebuffer.h"
+#include "Sora/Renderer/RenderTargetPool.h"
+
+typedef struct __GLsync* GLsync;
 
 namespace Sora {
 
 	class OpenGLFramebuffer : public Framebuffer
 	{
 	public:
+		static const uint32_t ReadbackSlotCount = 3;
+
 		OpenGLFramebuffer(const FramebufferSpecification& spec);
 		virtual ~OpenGLFramebuffer();
 
@@ -21,12 +26,22 @@ namespace Sora {
 			return mColorAttachments[index]; 
 		}
 
+		virtual uint32_t GetAttachmentWidth() const override { return mAttachmentWidth; }
+		virtual uint32_t GetAttachmentHeight() const override { return mAttachmentHeight; }
+
 		virtual const FramebufferSpecification& GetSpecification() const override { return mSpecification; }
 
 		virtual void Resize(uint32_t width, uint32_t height) override;
 		virtual int ReadPixel(uint32_t attachment_index, int x, int y) override;
+
+		virtual uint64_t RequestReadback(uint32_t attachment_index, int x, int y, uint32_t width, uint32_t height) override;
+		virtual bool PollReadback(FramebufferReadback& o_Readback) override;
 		
 		virtual void ClearAttachment(uint32_t attachment_index, int value) override;
+		virtual void ClearAttachment(uint32_t attachment_index, const glm::vec4& value) override;
+		virtual void ClearDepthAttachment(float value) override;
+	private:
+		void ReleaseAttachments();
 	private:
 		uint32_t mRendererID = 0;
 		FramebufferSpecification mSpecification;
@@ -34,8 +49,26 @@ namespace Sora {
 		std::vector<FramebufferTextureSpecification> mColorAttachmentSpecifications;
 		FramebufferTextureSpecification mDepthAttachmentSpecifications = FramebufferTextureFormat::None;
 
+		// From the render target pool, rounded up to its bucket size.
+		Ref<RenderTargetPool> mPool;
 		std::vector<uint32_t> mColorAttachments;
-		uint32_t mDepthAttachment;
+		uint32_t mDepthAttachment = 0;
+		uint32_t mAttachmentWidth = 0, mAttachmentHeight = 0;
+
+		// A ring of pixel pack buffers, each persistently mapped and grown to the largest region read through it.
+		struct ReadbackSlot
+		{
+			uint32_t BufferID = 0;
+			const int* MappedData = nullptr;
+			size_t Capacity = 0;
+			GLsync Fence = nullptr;
+			FramebufferReadback Readback;
+		};
+
+		std::array<ReadbackSlot, ReadbackSlotCount> mReadbackSlots;
+		uint32_t mOldestReadback = 0;
+		uint32_t mPendingReadbackCount = 0;
+		uint64_t mNextReadbackID = 1;
 	};
 
 }
\ No newline at end of file
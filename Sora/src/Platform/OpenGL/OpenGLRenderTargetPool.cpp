@@ -0,0 +1,141 @@
+#include "sorapch.h"
+#include "OpenGLRenderTargetPool.h"
+
+#include <glad/glad.h>
+
+namespace Sora {
+
+	namespace Utils {
+
+		static GLenum ToGLInternalFormat(FramebufferTextureFormat format)
+		{
+			switch (format)
+			{
+				case FramebufferTextureFormat::RGBA8:			return GL_RGBA8;
+				case FramebufferTextureFormat::RED_INTEGER:		return GL_R32I;
+				case FramebufferTextureFormat::DEPTH24STENCIL8:	return GL_DEPTH24_STENCIL8;
+			}
+
+			SORA_CORE_ASSERT(false, "Unknown framebuffer texture format!");
+			return 0;
+		}
+
+		static uint32_t GetBytesPerPixel(FramebufferTextureFormat format)
+		{
+			switch (format)
+			{
+				case FramebufferTextureFormat::RGBA8:			return 4;
+				case FramebufferTextureFormat::RED_INTEGER:		return 4;
+				case FramebufferTextureFormat::DEPTH24STENCIL8:	return 4;
+			}
+
+			SORA_CORE_ASSERT(false, "Unknown framebuffer texture format!");
+			return 0;
+		}
+
+	}
+
+	OpenGLRenderTargetPool::~OpenGLRenderTargetPool()
+	{
+		for (const Entry& entry : m_Entries)
+			glDeleteTextures(1, &entry.RendererID);
+	}
+
+	uint32_t OpenGLRenderTargetPool::Acquire(FramebufferTextureFormat format, uint32_t samples, uint32_t width, uint32_t height)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		for (Entry& entry : m_Entries)
+		{
+			if (!entry.InUse && entry.Format == format && entry.Samples == samples && entry.Width == width && entry.Height == height)
+			{
+				entry.InUse = true;
+				entry.IdleFrames = 0;
+				m_ReuseCount++;
+				return entry.RendererID;
+			}
+		}
+
+		Entry entry;
+		entry.Format = format;
+		entry.Samples = samples;
+		entry.Width = width;
+		entry.Height = height;
+		entry.Bytes = (uint64_t)width * height * samples * Utils::GetBytesPerPixel(format);
+		entry.InUse = true;
+
+		const GLenum internalFormat = Utils::ToGLInternalFormat(format);
+		if (samples > 1)
+		{
+			glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &entry.RendererID);
+			glTextureStorage2DMultisample(entry.RendererID, samples, internalFormat, width, height, GL_FALSE);
+		}
+		else
+		{
+			glCreateTextures(GL_TEXTURE_2D, 1, &entry.RendererID);
+			glTextureStorage2D(entry.RendererID, 1, internalFormat, width, height);
+
+			// Integer textures cannot be filtered, and depth is never sampled.
+			const GLenum filter = format == FramebufferTextureFormat::RGBA8 ? GL_LINEAR : GL_NEAREST;
+			glTextureParameteri(entry.RendererID, GL_TEXTURE_MIN_FILTER, filter);
+			glTextureParameteri(entry.RendererID, GL_TEXTURE_MAG_FILTER, filter);
+			glTextureParameteri(entry.RendererID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(entry.RendererID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		}
+
+		m_AllocationCount++;
+		m_Entries.push_back(entry);
+		return entry.RendererID;
+	}
+
+	void OpenGLRenderTargetPool::Release(uint32_t rendererID)
+	{
+		for (Entry& entry : m_Entries)
+		{
+			if (entry.RendererID == rendererID)
+			{
+				SORA_CORE_ASSERT(entry.InUse, "Render target released twice!");
+				entry.InUse = false;
+				entry.IdleFrames = 0;
+				return;
+			}
+		}
+
+		SORA_CORE_ASSERT(false, "Render target {0} does not belong to the pool!", rendererID);
+	}
+
+	void OpenGLRenderTargetPool::OnUpdate()
+	{
+		for (auto it = m_Entries.begin(); it != m_Entries.end(); )
+		{
+			if (!it->InUse && ++it->IdleFrames > RetainFrameCount)
+			{
+				glDeleteTextures(1, &it->RendererID);
+				it = m_Entries.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	RenderTargetPool::Statistics OpenGLRenderTargetPool::GetStats() const
+	{
+		Statistics stats;
+		stats.TextureCount = (uint32_t)m_Entries.size();
+		stats.Allocations = m_AllocationCount;
+		stats.Reuses = m_ReuseCount;
+		for (const Entry& entry : m_Entries)
+		{
+			stats.AllocatedBytes += entry.Bytes;
+			if (entry.InUse)
+			{
+				stats.InUseCount++;
+				stats.InUseBytes += entry.Bytes;
+			}
+		}
+		return stats;
+	}
+
+}
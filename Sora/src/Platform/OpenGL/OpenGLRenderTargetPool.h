@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Sora/Renderer/RenderTargetPool.h"
+
+namespace Sora {
+
+	class OpenGLRenderTargetPool : public RenderTargetPool
+	{
+	public:
+		// Frames a released texture is kept for before it is freed.
+		static const uint32_t RetainFrameCount = 300;
+
+		OpenGLRenderTargetPool() = default;
+		virtual ~OpenGLRenderTargetPool();
+
+		virtual uint32_t Acquire(FramebufferTextureFormat format, uint32_t samples, uint32_t width, uint32_t height) override;
+		virtual void Release(uint32_t rendererID) override;
+
+		virtual void OnUpdate() override;
+
+		virtual Statistics GetStats() const override;
+	private:
+		struct Entry
+		{
+			uint32_t RendererID = 0;
+			FramebufferTextureFormat Format = FramebufferTextureFormat::None;
+			uint32_t Samples = 1;
+			uint32_t Width = 0, Height = 0;
+			uint64_t Bytes = 0;
+			bool InUse = false;
+			uint32_t IdleFrames = 0;
+		};
+
+		std::vector<Entry> m_Entries;
+		uint32_t m_AllocationCount = 0;
+		uint32_t m_ReuseCount = 0;
+	};
+
+}
@@ -12,8 +12,9 @@ namespace Sora {
 		glEnable(GL_BLEND);
 		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+		// Of two sprites at the same depth the later one wins, which is the one on the higher layer.
 		glEnable(GL_DEPTH_TEST);
-		//glDepthFunc(GL_LEQUAL);
+		glDepthFunc(GL_LEQUAL);
 
 		glEnable(GL_LINE_SMOOTH);
 	}
@@ -33,17 +34,53 @@ namespace Sora {
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	}
 
-	void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, std::optional<uint32_t> indexCount /*= std::nullopt*/)
+	void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, std::optional<uint32_t> indexCount /*= std::nullopt*/, uint32_t baseVertex /*= 0*/)
 	{
 		vertexArray->Bind();
 		uint32_t count = indexCount.value_or(vertexArray->GetIndexBuffer()->GetCount());
-		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+		if (baseVertex)
+			glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, baseVertex);
+		else
+			glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
 	}
 
-	void OpenGLRendererAPI::DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
+	void OpenGLRendererAPI::DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance /*= 0*/)
 	{
 		vertexArray->Bind();
-		glDrawArrays(GL_LINES, 0, vertexCount);
+		glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr, instanceCount, baseInstance);
+	}
+
+	void OpenGLRendererAPI::DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex /*= 0*/)
+	{
+		vertexArray->Bind();
+		glDrawArrays(GL_LINES, firstVertex, vertexCount);
+	}
+
+	void OpenGLRendererAPI::MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const DrawIndexedIndirectCommand* commands, uint32_t drawCount)
+	{
+		if (!m_IndirectBuffer)
+			glCreateBuffers(1, &m_IndirectBuffer);
+
+		// A handful of commands per call: orphaning the storage each time is cheaper than synchronizing a ring.
+		glNamedBufferData(m_IndirectBuffer, drawCount * sizeof(DrawIndexedIndirectCommand), commands, GL_STREAM_DRAW);
+
+		vertexArray->Bind();
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_IndirectBuffer);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, drawCount, 0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+	void OpenGLRendererAPI::MultiDrawLinesIndirect(const Ref<VertexArray>& vertexArray, const DrawArraysIndirectCommand* commands, uint32_t drawCount)
+	{
+		if (!m_IndirectBuffer)
+			glCreateBuffers(1, &m_IndirectBuffer);
+
+		glNamedBufferData(m_IndirectBuffer, drawCount * sizeof(DrawArraysIndirectCommand), commands, GL_STREAM_DRAW);
+
+		vertexArray->Bind();
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_IndirectBuffer);
+		glMultiDrawArraysIndirect(GL_LINES, nullptr, drawCount, 0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 	}
 
 	void OpenGLRendererAPI::SetLineWidth(float width)
@@ -51,4 +88,9 @@ namespace Sora {
 		glLineWidth(width);
 	}
 
+	void OpenGLRendererAPI::SetDepthWrite(bool enabled)
+	{
+		glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+	}
+
 }
@@ -12,10 +12,16 @@ namespace Sora {
 		virtual void SetClearColor(const glm::vec4& color) override;
 		virtual void Clear() override;
 
-		virtual void DrawIndexed(const Ref<VertexArray>& vertex_array, std::optional<uint32_t> index_count) override;
-		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) override;
+		virtual void DrawIndexed(const Ref<VertexArray>& vertex_array, std::optional<uint32_t> index_count, uint32_t baseVertex) override;
+		virtual void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance) override;
+		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex) override;
+		virtual void MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const DrawIndexedIndirectCommand* commands, uint32_t drawCount) override;
+		virtual void MultiDrawLinesIndirect(const Ref<VertexArray>& vertexArray, const DrawArraysIndirectCommand* commands, uint32_t drawCount) override;
 
 		virtual void SetLineWidth(float width) override;
+		virtual void SetDepthWrite(bool enabled) override;
+	private:
+		uint32_t m_IndirectBuffer = 0;	// Created on first use, the API object exists before the GL context does.
 	};
 
 }
@@ -15,6 +15,8 @@
 
 #include "Sora/Core/Timer.h"
 
+#include <execution>
+
 namespace Sora {
 
 	namespace Utils {
@@ -26,7 +28,6 @@ namespace Sora {
 			if (type == "fragment" || type == "pixel")
 				return GL_FRAGMENT_SHADER;
 
-			SORA_CORE_ASSERT(false, "Unknown shader type '{0}'", type);
 			return 0;
 		}
 
@@ -61,9 +62,11 @@ namespace Sora {
 
 		static void CreateCacheDirectoryIfNeeded()
 		{
+			// Shaders compiling in parallel may race to create it, which is harmless.
+			std::error_code error;
 			std::string cache_directory = GetCacheDirectory();
 			if (!std::filesystem::exists(cache_directory))
-				std::filesystem::create_directories(cache_directory);
+				std::filesystem::create_directories(cache_directory, error);
 		}
 
 		static const char* GLShaderStageCachedOpenGLFileExtension(uint32_t stage)
@@ -78,6 +81,11 @@ namespace Sora {
 			return "";
 		}
 
+		static const char* CachedProgramFileExtension()
+		{
+			return ".cached_opengl.program";
+		}
+
 		static const char* GLShaderStageCachedVulkanFileExtension(uint32_t stage)
 		{
 			switch (stage)
@@ -89,26 +97,115 @@ namespace Sora {
 			SORA_CORE_ASSERT(false, "Unknown shader stage");
 			return "";
 		}
+
+		// Bump when the compile steps change in a way the options strings below do not capture.
+		static const uint32_t CacheVersion = 1;
+
+		static const char* VulkanCompileOptions()
+		{
+			return "vulkan_1_3;optimization_performance";
+		}
+
+		static const char* OpenGLCompileOptions()
+		{
+			return "opengl_4_5;spirv_cross;optimization_zero";
+		}
+
+		// FNV-1a, 64 bit.
+		static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+		{
+			const uint8_t* bytes = (const uint8_t*)data;
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		static uint64_t HashCompileInput(const void* data, size_t size, const char* options)
+		{
+			uint64_t hash = HashBytes(&CacheVersion, sizeof(CacheVersion));
+			hash = HashBytes(options, strlen(options), hash);
+			return HashBytes(data, size, hash);
+		}
+
+		// <name>.<hash><extension>. Entries of the same shader and stage under another hash are stale.
+		static std::filesystem::path GetCachePath(const std::string& name, uint64_t hash, const char* extension)
+		{
+			char hex[17];
+			snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+			return std::filesystem::path(GetCacheDirectory()) / (name + "." + hex + extension);
+		}
+
+		// Program binaries are only valid for the driver that produced them. Must first be called on the thread owning
+		// the GL context.
+		static const std::string& GetDriverIdentity()
+		{
+			static const std::string identity = std::string((const char*)glGetString(GL_RENDERER)) + ";" +
+				(const char*)glGetString(GL_VERSION);
+			return identity;
+		}
+
+		static bool ReadCachedBinary(const std::filesystem::path& path, std::vector<uint32_t>& data)
+		{
+			std::ifstream in(path, std::ios::in | std::ios::binary);
+			if (!in.is_open())
+				return false;
+
+			in.seekg(0, std::ios::end);
+			auto size = (size_t)in.tellg();
+			in.seekg(0, std::ios::beg);
+			if (size == 0 || size % sizeof(uint32_t) != 0)
+				return false;
+
+			data.resize(size / sizeof(uint32_t));
+			in.read((char*)data.data(), size);
+			return (bool)in;
+		}
+
+		template<typename T>
+		static void WriteCachedBinary(const std::filesystem::path& path, const std::vector<T>& data, const std::string& name, const char* extension)
+		{
+			std::ofstream out(path, std::ios::out | std::ios::binary);
+			if (out.is_open())
+			{
+				out.write((const char*)data.data(), data.size() * sizeof(T));
+				out.close();
+			}
+
+			std::error_code error;
+			const std::string prefix = name + ".";
+			for (const auto& entry : std::filesystem::directory_iterator(GetCacheDirectory(), error))
+			{
+				const std::string filename = entry.path().filename().string();
+				if (entry.path() != path && filename.starts_with(prefix) && filename.ends_with(extension) &&
+					filename.size() == prefix.size() + 16 + strlen(extension))
+					std::filesystem::remove(entry.path(), error);
+			}
+		}
 	}
 
 	OpenGLShader::OpenGLShader(const std::string& filepath)
-		: mFilepath(filepath)
+		: OpenGLShader(filepath, DeferProgram{})
 	{
 		SORA_PROFILE_FUNCTION();
 
-		Utils::CreateCacheDirectoryIfNeeded();
-
-		std::string source = ReadFile(filepath);
-		auto shaderSources = PreProcess(source);
-
+		Utils::GetDriverIdentity();
+		if (!Compile())
 		{
-			Timer timer;
-			CompileOrGetVulkanBinaries(shaderSources);
-			CompileOrGetOpenGLBinaries();
-			CreateProgram();
-			SORA_CORE_WARN("Shader creation took {0} ms", timer.ElapsedMillis());
+			ReportCompileFailure();
+			return;
 		}
 
+		Timer timer;
+		CreateProgram();
+		LogCompileStats(timer.ElapsedMillis());
+	}
+
+	OpenGLShader::OpenGLShader(const std::string& filepath, DeferProgram)
+		: mFilepath(filepath)
+	{
 		auto last_slash = filepath.find_last_of("/\\");
 		last_slash = last_slash == std::string::npos ? 0 : last_slash + 1;
 		auto last_dot = filepath.rfind('.');
@@ -121,13 +218,60 @@ namespace Sora {
 	{
 		SORA_PROFILE_FUNCTION();
 
-		std::unordered_map<GLenum, std::string> sources;
-		sources[GL_VERTEX_SHADER] = vertex_src;
-		sources[GL_FRAGMENT_SHADER] = fragment_src;
-		
-		CompileOrGetVulkanBinaries(sources);
-		CompileOrGetOpenGLBinaries();
+		mShaderSources[GL_VERTEX_SHADER] = vertex_src;
+		mShaderSources[GL_FRAGMENT_SHADER] = fragment_src;
+
+		Utils::GetDriverIdentity();
+		if (!Compile())
+		{
+			ReportCompileFailure();
+			return;
+		}
+
+		Timer timer;
 		CreateProgram();
+		LogCompileStats(timer.ElapsedMillis());
+	}
+
+	std::vector<Ref<Shader>> OpenGLShader::CreateAll(const std::vector<std::string>& filepaths)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		Timer timer;
+
+		Utils::GetDriverIdentity();
+
+		std::vector<Ref<OpenGLShader>> shaders;
+		for (const std::string& filepath : filepaths)
+			shaders.push_back(Ref<OpenGLShader>(new OpenGLShader(filepath, DeferProgram{})));
+
+		// One flag per shader, written by the thread compiling it.
+		std::vector<uint8_t> compiled(shaders.size());
+		std::for_each(std::execution::par, shaders.begin(), shaders.end(), [&shaders, &compiled](const Ref<OpenGLShader>& shader)
+			{
+				compiled[&shader - shaders.data()] = shader->Compile();
+			});
+
+		// Linking needs the GL context, which belongs to this thread.
+		std::vector<Ref<Shader>> result;
+		for (size_t i = 0; i < shaders.size(); i++)
+		{
+			const Ref<OpenGLShader>& shader = shaders[i];
+			if (!compiled[i])
+			{
+				shader->ReportCompileFailure();
+				result.push_back(shader);
+				continue;
+			}
+
+			Timer linkTimer;
+			shader->CreateProgram();
+			shader->LogCompileStats(linkTimer.ElapsedMillis());
+			result.push_back(shader);
+		}
+
+		SORA_CORE_INFO("Created {0} shaders in {1:.2f} ms", shaders.size(), timer.ElapsedMillis());
+		return result;
 	}
 
 	OpenGLShader::~OpenGLShader()
@@ -137,6 +281,148 @@ namespace Sora {
 		glDeleteProgram(mRendererID);
 	}
 
+	void OpenGLShader::ReportCompileFailure() const
+	{
+		// Nothing to link, and no earlier program to fall back to. The shader draws nothing until a hot reload of the
+		// fixed file succeeds, rather than taking the application down over a typo.
+		SORA_CORE_ERROR("Shader '{0}' failed to compile, it has no program until it is fixed and reloaded", mName);
+	}
+
+	bool OpenGLShader::CompileReload()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		mPendingReload = Ref<OpenGLShader>(new OpenGLShader(mFilepath, DeferProgram{}));
+		mPendingReloadCompiled = mPendingReload->Compile();
+		return mPendingReloadCompiled;
+	}
+
+	bool OpenGLShader::FinishReload()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		Ref<OpenGLShader> reload = std::move(mPendingReload);
+		// ShaderLibrary reports the outcome, with the timings it measured.
+		if (!reload || !mPendingReloadCompiled || !reload->CreateProgram())
+			return false;
+
+		// The reload object takes the old program with it when it goes out of scope.
+		std::swap(mRendererID, reload->mRendererID);
+		std::swap(mShaderSources, reload->mShaderSources);
+		std::swap(mVulkanSPIRV, reload->mVulkanSPIRV);
+		std::swap(mOpenGLSPIRV, reload->mOpenGLSPIRV);
+		std::swap(mOpenGLSourceCode, reload->mOpenGLSourceCode);
+		std::swap(mStageStats, reload->mStageStats);
+		std::swap(mProgramCachePath, reload->mProgramCachePath);
+		std::swap(mProgramFromBinary, reload->mProgramFromBinary);
+		std::swap(mUniformLocations, reload->mUniformLocations);
+		std::swap(mUniformBlocks, reload->mUniformBlocks);
+		return true;
+	}
+
+	bool OpenGLShader::Compile()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		Utils::CreateCacheDirectoryIfNeeded();
+
+		if (!mFilepath.empty())
+			mShaderSources = PreProcess(ReadFile(mFilepath));
+
+		if (mShaderSources.empty())
+		{
+			SORA_CORE_ERROR("Shader '{0}' has no stages", mName);
+			return false;
+		}
+
+		// A program binary linked from the same sources by the same driver skips every SPIR-V step.
+		std::vector<GLenum> stages;
+		for (auto&& [stage, source] : mShaderSources)
+			stages.push_back(stage);
+		std::sort(stages.begin(), stages.end());
+
+		uint64_t programKey = Utils::HashBytes(Utils::GetDriverIdentity().data(), Utils::GetDriverIdentity().size());
+		programKey = Utils::HashBytes(Utils::VulkanCompileOptions(), strlen(Utils::VulkanCompileOptions()), programKey);
+		for (GLenum stage : stages)
+		{
+			const std::string& source = mShaderSources.at(stage);
+			programKey = Utils::HashBytes(&stage, sizeof(stage), programKey);
+			programKey = Utils::HashBytes(source.data(), source.size(), programKey);
+		}
+		mProgramCachePath = Utils::GetCachePath(mName, Utils::HashCompileInput(&programKey, sizeof(programKey),
+			Utils::OpenGLCompileOptions()), Utils::CachedProgramFileExtension()).string();
+
+		mStageStats.clear();
+		mProgramBinary.clear();
+		mProgramFromBinary = false;
+
+		std::ifstream in(mProgramCachePath, std::ios::in | std::ios::binary);
+		if (in.is_open())
+		{
+			in.seekg(0, std::ios::end);
+			auto size = (size_t)in.tellg();
+			in.seekg(0, std::ios::beg);
+			mProgramBinary.resize(size);
+			in.read((char*)mProgramBinary.data(), size);
+			if (in && size > sizeof(GLenum))
+				return true;
+
+			mProgramBinary.clear();
+		}
+
+		return CompileStages();
+	}
+
+	bool OpenGLShader::CompileStages()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		// Every stage owns its entries, created up front so that the maps are not modified while stages run in parallel.
+		mVulkanSPIRV.clear();
+		mOpenGLSPIRV.clear();
+		mOpenGLSourceCode.clear();
+		mStageStats.clear();
+
+		std::vector<GLenum> stages;
+		for (auto&& [stage, source] : mShaderSources)
+		{
+			stages.push_back(stage);
+			mVulkanSPIRV[stage];
+			mOpenGLSPIRV[stage];
+			mOpenGLSourceCode[stage];
+			mStageStats[stage];
+		}
+
+		std::for_each(std::execution::par, stages.begin(), stages.end(), [this](GLenum stage)
+			{
+				Timer timer;
+				StageStats& stats = mStageStats.at(stage);
+				stats.Compiled = CompileOrGetVulkanBinary(stage, mShaderSources.at(stage), stats) && CompileOrGetOpenGLBinary(stage, stats);
+				stats.Milliseconds = timer.ElapsedMillis();
+			});
+
+		for (auto&& [stage, stats] : mStageStats)
+		{
+			if (!stats.Compiled)
+				return false;
+		}
+
+		for (auto&& [stage, data] : mVulkanSPIRV)
+			Reflect(stage, data);
+
+		return true;
+	}
+
+	void OpenGLShader::LogCompileStats(float linkMilliseconds) const
+	{
+		for (auto&& [stage, stats] : mStageStats)
+		{
+			SORA_CORE_INFO("Shader '{0}' {1}: {2:.2f} ms (Vulkan SPIR-V {3}, OpenGL SPIR-V {4})", mName, Utils::GLShaderStageToString(stage),
+				stats.Milliseconds, stats.VulkanCacheHit ? "cached" : "compiled", stats.OpenGLCacheHit ? "cached" : "compiled");
+		}
+		SORA_CORE_INFO("Shader '{0}' program: {1:.2f} ms ({2})", mName, linkMilliseconds, mProgramFromBinary ? "program binary cache" : "linked");
+	}
+
 	std::string OpenGLShader::ReadFile(const std::string& filepath)
 	{
 		SORA_PROFILE_FUNCTION();
@@ -170,11 +456,20 @@ namespace Sora {
 		size_t pos = source.find(type_token, 0);
 		while (pos != std::string::npos)
 		{
+			// Reported rather than asserted, the file may be mid-edit when it is reloaded.
 			size_t eol = source.find_first_of("\r\n", pos);
-			SORA_CORE_ASSERT(eol != std::string::npos, "Syntax error");
+			if (eol == std::string::npos)
+			{
+				SORA_CORE_ERROR("Syntax error in shader '{0}'", mName);
+				return {};
+			}
 			size_t begin = pos + type_token_length + 1;
 			std::string type = source.substr(begin, eol - begin);
-			SORA_CORE_ASSERT(Utils::ShaderTypeFromString(type), "Invalid shader type specified '{0}'", type);
+			if (!Utils::ShaderTypeFromString(type))
+			{
+				SORA_CORE_ERROR("Invalid shader type specified '{0}' in shader '{1}'", type, mName);
+				return {};
+			}
 
 			size_t next_line_pos = source.find_first_of("\r\n", eol);
 			pos = source.find(type_token, next_line_pos);
@@ -184,118 +479,128 @@ namespace Sora {
 		return shader_sources;
 	}
 
-	void OpenGLShader::CompileOrGetVulkanBinaries(const std::unordered_map<GLenum, std::string>& shader_sources)
+	bool OpenGLShader::CompileOrGetVulkanBinary(GLenum stage, const std::string& source, StageStats& stats)
 	{
-		GLuint program = glCreateProgram();
+		// Keyed on the stage source and the options, so an edited file never loads a stale binary.
+		const char* extension = Utils::GLShaderStageCachedVulkanFileExtension(stage);
+		uint64_t hash = Utils::HashCompileInput(source.data(), source.size(), Utils::VulkanCompileOptions());
+		std::filesystem::path cache_path = Utils::GetCachePath(mName, hash, extension);
+
+		auto& data = mVulkanSPIRV.at(stage);
+		stats.VulkanCacheHit = Utils::ReadCachedBinary(cache_path, data);
+		if (stats.VulkanCacheHit)
+			return true;
+
 		shaderc::Compiler compiler;
 		shaderc::CompileOptions options;
 		options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
-		const bool optimize = true;
-		if (optimize)
-			options.SetOptimizationLevel(shaderc_optimization_level_performance);
-
-		std::filesystem::path cache_directory = Utils::GetCacheDirectory();
+		options.SetOptimizationLevel(shaderc_optimization_level_performance);
 
-		auto& shader_data = mVulkanSPIRV;
-		shader_data.clear();
-		for (auto&& [stage, source] : shader_sources)
+		shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(source, Utils::GLShaderStageToShaderC(stage),
+			mFilepath.empty() ? mName.c_str() : mFilepath.c_str(), options);
+		if (module.GetCompilationStatus() != shaderc_compilation_status_success)
 		{
-			std::filesystem::path shader_file_path = mFilepath;
-			std::filesystem::path cache_path = cache_directory / (shader_file_path.filename().string() +
-				Utils::GLShaderStageCachedVulkanFileExtension(stage));
-
-			std::ifstream in(cache_path, std::ios::in | std::ios::binary);
-			if (in.is_open())
-			{
-				in.seekg(0, std::ios::end);
-				auto size = in.tellg();
-				in.seekg(0, std::ios::beg);
-
-				auto& data = shader_data[stage];
-				data.resize(size / sizeof(uint32_t));
-				in.read((char*)data.data(), size);
-			}
-			else
-			{
-				shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(source, Utils::GLShaderStageToShaderC(stage),
-					mFilepath.c_str(), options);
-				SORA_CORE_ASSERT(module.GetCompilationStatus() == shaderc_compilation_status_success, module.GetErrorMessage());
-				
-				shader_data[stage] = std::vector<uint32_t>(module.cbegin(), module.cend());
-
-				std::ofstream out(cache_path, std::ios::out | std::ios::binary);
-				if (out.is_open())
-				{
-					auto& data = shader_data[stage];
-					out.write((char*)data.data(), data.size() * sizeof(uint32_t));
-					out.flush();
-					out.close();
-				}
-			}
+			SORA_CORE_ERROR("Shader '{0}' {1} failed to compile:\n{2}", mName, Utils::GLShaderStageToString(stage), module.GetErrorMessage());
+			return false;
 		}
 
-		for (auto&& [stage, data] : shader_data)
-			Reflect(stage, data);
+		data = std::vector<uint32_t>(module.cbegin(), module.cend());
+		Utils::WriteCachedBinary(cache_path, data, mName, extension);
+		return true;
 	}
 
-	void OpenGLShader::CompileOrGetOpenGLBinaries()
+	bool OpenGLShader::CompileOrGetOpenGLBinary(GLenum stage, StageStats& stats)
 	{
-		auto& shader_data = mOpenGLSPIRV;
+		// Derived from the Vulkan binary alone, so it is keyed on that and follows it whenever it changes.
+		const auto& spirv = mVulkanSPIRV.at(stage);
+		const char* extension = Utils::GLShaderStageCachedOpenGLFileExtension(stage);
+		uint64_t hash = Utils::HashCompileInput(spirv.data(), spirv.size() * sizeof(uint32_t), Utils::OpenGLCompileOptions());
+		std::filesystem::path cache_path = Utils::GetCachePath(mName, hash, extension);
+
+		auto& data = mOpenGLSPIRV.at(stage);
+		stats.OpenGLCacheHit = Utils::ReadCachedBinary(cache_path, data);
+		if (stats.OpenGLCacheHit)
+			return true;
+
 		shaderc::Compiler compiler;
 		shaderc::CompileOptions options;
 		options.SetTargetEnvironment(shaderc_target_env_opengl, shaderc_env_version_opengl_4_5);
-		const bool optimize = false;
-		if (optimize)
-			options.SetOptimizationLevel(shaderc_optimization_level_performance);
 
-		std::filesystem::path cache_directory = Utils::GetCacheDirectory();
-		
-		shader_data.clear();
-		mOpenGLSourceCode.clear();
-		for (auto&& [stage, spirv] : mVulkanSPIRV)
+		spirv_cross::CompilerGLSL glsl_compiler(spirv);
+		auto& source = mOpenGLSourceCode.at(stage);
+		source = glsl_compiler.compile();
+
+		shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(source, Utils::GLShaderStageToShaderC(stage),
+			mFilepath.empty() ? mName.c_str() : mFilepath.c_str(), options);
+		if (module.GetCompilationStatus() != shaderc_compilation_status_success)
 		{
-			std::filesystem::path shader_file_path = mFilepath;
-			std::filesystem::path cache_path = cache_directory / (shader_file_path.filename().string() +
-				Utils::GLShaderStageCachedOpenGLFileExtension(stage));
+			SORA_CORE_ERROR("Shader '{0}' {1} failed to compile:\n{2}", mName, Utils::GLShaderStageToString(stage), module.GetErrorMessage());
+			return false;
+		}
 
-			std::ifstream in(cache_path, std::ios::in | std::ios::binary);
-			if (in.is_open())
-			{
-				in.seekg(0, std::ios::end);
-				auto size = in.tellg();
-				in.seekg(0, std::ios::beg);
+		data = std::vector<uint32_t>(module.cbegin(), module.cend());
+		Utils::WriteCachedBinary(cache_path, data, mName, extension);
+		return true;
+	}
 
-				auto& data = shader_data[stage];
-				data.resize(size / sizeof(uint32_t));
-				in.read((char*)data.data(), size);
-			}
-			else
-			{
-				spirv_cross::CompilerGLSL glsl_compiler(spirv);
-				mOpenGLSourceCode[stage] = glsl_compiler.compile();
-				auto& source = mOpenGLSourceCode[stage];
-
-				shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(source, Utils::GLShaderStageToShaderC(stage),
-					mFilepath.c_str(), options);
-				SORA_CORE_ASSERT(module.GetCompilationStatus() == shaderc_compilation_status_success, module.GetErrorMessage());
-
-				shader_data[stage] = std::vector<uint32_t>(module.cbegin(), module.cend());
-
-				std::ofstream out(cache_path, std::ios::out | std::ios::binary);
-				if (out.is_open())
-				{
-					auto& data = shader_data[stage];
-					out.write((char*)data.data(), data.size() * sizeof(uint32_t));
-					out.flush();
-					out.close();
-				}
-			}
+	bool OpenGLShader::LoadProgramBinary()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		// Cache file layout: the binary format, followed by the binary.
+		GLenum format;
+		memcpy(&format, mProgramBinary.data(), sizeof(GLenum));
+
+		GLuint program = glCreateProgram();
+		glProgramBinary(program, format, mProgramBinary.data() + sizeof(GLenum), (GLsizei)(mProgramBinary.size() - sizeof(GLenum)));
+		mProgramBinary.clear();
+
+		// Drivers reject binaries after an update, or for no stated reason at all.
+		GLint is_linked;
+		glGetProgramiv(program, GL_LINK_STATUS, &is_linked);
+		if (is_linked == GL_FALSE)
+		{
+			SORA_CORE_WARN("Program binary of shader '{0}' was rejected by the driver, compiling from source", mName);
+			glDeleteProgram(program);
+			return false;
 		}
+
+		mRendererID = program;
+		return true;
+	}
+
+	void OpenGLShader::SaveProgramBinary(uint32_t program)
+	{
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0)
+			return;
+
+		std::vector<uint8_t> data(sizeof(GLenum) + length);
+		GLenum format;
+		glGetProgramBinary(program, length, nullptr, &format, data.data() + sizeof(GLenum));
+		memcpy(data.data(), &format, sizeof(GLenum));
+
+		Utils::WriteCachedBinary(mProgramCachePath, data, mName, Utils::CachedProgramFileExtension());
 	}
 
-	void OpenGLShader::CreateProgram()
+	bool OpenGLShader::CreateProgram()
 	{
+		if (!mProgramBinary.empty())
+		{
+			mProgramFromBinary = LoadProgramBinary();
+			if (mProgramFromBinary)
+			{
+				ReflectProgram();
+				return true;
+			}
+
+			if (!CompileStages())
+				return false;
+		}
+
 		GLuint program = glCreateProgram();
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		std::vector<GLuint> shader_ids;
 		for (auto&& [stage, spirv] : mOpenGLSPIRV)
 		{
@@ -322,8 +627,13 @@ namespace Sora {
 
 			for (auto id : shader_ids)
 				glDeleteShader(id);
+
+			mRendererID = 0;
+			return false;
 		}
 
+		SaveProgramBinary(program);
+
 		for (auto id : shader_ids)
 		{
 			glDetachShader(program, id);
@@ -331,6 +641,84 @@ namespace Sora {
 		}
 
 		mRendererID = program;
+		ReflectProgram();
+		return true;
+	}
+
+	void OpenGLShader::ReflectProgram()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		mUniformLocations.clear();
+		mUniformBlocks.clear();
+
+		GLint uniformCount = 0;
+		glGetProgramInterfaceiv(mRendererID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+
+		GLint blockCount = 0;
+		glGetProgramInterfaceiv(mRendererID, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &blockCount);
+		mUniformBlocks.resize(blockCount);
+
+		for (GLint i = 0; i < blockCount; i++)
+		{
+			const GLenum properties[] = { GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE };
+			GLint values[3] = {};
+			glGetProgramResourceiv(mRendererID, GL_UNIFORM_BLOCK, i, 3, properties, 3, nullptr, values);
+
+			ShaderUniformBlock& block = mUniformBlocks[i];
+			block.Name.resize(std::max(values[0], 1));
+			glGetProgramResourceName(mRendererID, GL_UNIFORM_BLOCK, i, values[0], nullptr, block.Name.data());
+			block.Name.resize(strlen(block.Name.c_str()));
+			block.Binding = values[1];
+			block.Size = values[2];
+		}
+
+		for (GLint i = 0; i < uniformCount; i++)
+		{
+			const GLenum properties[] = { GL_NAME_LENGTH, GL_LOCATION, GL_BLOCK_INDEX, GL_OFFSET };
+			GLint values[4] = {};
+			glGetProgramResourceiv(mRendererID, GL_UNIFORM, i, 4, properties, 4, nullptr, values);
+
+			std::string name(std::max(values[0], 1), '\0');
+			glGetProgramResourceName(mRendererID, GL_UNIFORM, i, values[0], nullptr, name.data());
+			name.resize(strlen(name.c_str()));
+
+			// Block members have no location, only an offset inside their block.
+			if (values[2] != -1)
+			{
+				mUniformBlocks[values[2]].Members.push_back({ name, (uint32_t)values[3] });
+				continue;
+			}
+
+			mUniformLocations[Utils::HashBytes(name.data(), name.size())] = values[1];
+
+			// Arrays are listed as "name[0]", but are as often looked up as "name".
+			if (name.ends_with("[0]"))
+				mUniformLocations[Utils::HashBytes(name.data(), name.size() - 3)] = values[1];
+		}
+
+		for (const ShaderUniformBlock& block : mUniformBlocks)
+		{
+			SORA_CORE_TRACE("Shader '{0}' uniform block {1}: binding {2}, {3} bytes", mName, block.Name, block.Binding, block.Size);
+			for (const auto& member : block.Members)
+				SORA_CORE_TRACE("    {0} at offset {1}", member.Name, member.Offset);
+		}
+	}
+
+	int32_t OpenGLShader::GetUniformLocation(const std::string& name) const
+	{
+		if (mRendererID == 0)
+			return -1;
+
+		uint64_t hash = Utils::HashBytes(name.data(), name.size());
+		auto it = mUniformLocations.find(hash);
+		if (it != mUniformLocations.end())
+			return it->second;
+
+		// SPIR-V programs may come without names, in which case only the driver knows.
+		GLint location = glGetUniformLocation(mRendererID, name.c_str());
+		mUniformLocations[hash] = location;
+		return location;
 	}
 
 	void OpenGLShader::Reflect(GLenum stage, const std::vector<uint32_t>& shader_data)
@@ -413,51 +801,81 @@ namespace Sora {
 		UploadUniformMat4(name, value);
 	}
 
+	void OpenGLShader::Set(ShaderUniform<int> uniform, int value)
+	{
+		glProgramUniform1i(mRendererID, uniform.Location, value);
+	}
+
+	void OpenGLShader::Set(ShaderUniform<int> uniform, const int* values, uint32_t count)
+	{
+		glProgramUniform1iv(mRendererID, uniform.Location, count, values);
+	}
+
+	void OpenGLShader::Set(ShaderUniform<float> uniform, float value)
+	{
+		glProgramUniform1f(mRendererID, uniform.Location, value);
+	}
+
+	void OpenGLShader::Set(ShaderUniform<glm::vec3> uniform, const glm::vec3& value)
+	{
+		glProgramUniform3f(mRendererID, uniform.Location, value.x, value.y, value.z);
+	}
+
+	void OpenGLShader::Set(ShaderUniform<glm::vec4> uniform, const glm::vec4& value)
+	{
+		glProgramUniform4f(mRendererID, uniform.Location, value.x, value.y, value.z, value.w);
+	}
+
+	void OpenGLShader::Set(ShaderUniform<glm::mat4> uniform, const glm::mat4& value)
+	{
+		glProgramUniformMatrix4fv(mRendererID, uniform.Location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
 	void OpenGLShader::UploadUniformInt(const std::string& name, int value) const
 	{
-		GLint location = glGetUniformLocation(mRendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform1i(location, value);
 	}
 
 	void OpenGLShader::UploadUniformIntArray(const std::string& name, int* values, uint32_t count) const
 	{
-		GLint location = glGetUniformLocation(mRendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform1iv(location, count, values);
 	}
 
 	void OpenGLShader::UploadUniformFloat(const std::string& name, float value) const
 	{
-		GLint location = glGetUniformLocation(mRendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform1f(location, value);
 	}
 
 	void OpenGLShader::UploadUniformFloat2(const std::string& name, const glm::vec2& value) const
 	{
-		GLint location = glGetUniformLocation(mRendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform2f(location, value.x, value.y);
 	}
 
 	void OpenGLShader::UploadUniformFloat3(const std::string& name, const glm::vec3& value) const
 	{
-		GLint location = glGetUniformLocation(mRendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform3f(location, value.x, value.y, value.z);
 	}
 
 	void OpenGLShader::UploadUniformFloat4(const std::string& name, const glm::vec4& value) const
 	{
-		GLint location = glGetUniformLocation(mRendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform4f(location, value.x, value.y, value.z, value.w);
 	}
 
 	void OpenGLShader::UploadUniformMat3(const std::string& name, const glm::mat3& value) const
 	{
-		GLint location = glGetUniformLocation(mRendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value));
 	}
 
 	void OpenGLShader::UploadUniformMat4(const std::string& name, const glm::mat4& value) const
 	{
-		GLint location = glGetUniformLocation(mRendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
 	}
 
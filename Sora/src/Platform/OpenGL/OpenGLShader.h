@@ -14,9 +14,15 @@ namespace Sora {
 		OpenGLShader(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
 		virtual ~OpenGLShader();
 
+		// Compiles all shaders, and all of their stages, on worker threads. The programs are then linked on the calling
+		// thread, which owns the GL context.
+		static std::vector<Ref<Shader>> CreateAll(const std::vector<std::string>& filepaths);
+
 		virtual void Bind() const override;
 		virtual void Unbind() const override;
 
+		virtual uint32_t GetRendererID() const override { return mRendererID; }
+
 		virtual void SetInt(const std::string& name, int value) override;
 		virtual void SetIntArray(const std::string& name, int* values, uint32_t count) override;
 		virtual void SetFloat(const std::string& name, float value) override;
@@ -24,7 +30,22 @@ namespace Sora {
 		virtual void SetFloat4(const std::string& name, const glm::vec4& value) override;
 		virtual void SetMat4(const std::string& name, const glm::mat4& value) override;
 
+		virtual int32_t GetUniformLocation(const std::string& name) const override;
+
+		virtual void Set(ShaderUniform<int> uniform, int value) override;
+		virtual void Set(ShaderUniform<int> uniform, const int* values, uint32_t count) override;
+		virtual void Set(ShaderUniform<float> uniform, float value) override;
+		virtual void Set(ShaderUniform<glm::vec3> uniform, const glm::vec3& value) override;
+		virtual void Set(ShaderUniform<glm::vec4> uniform, const glm::vec4& value) override;
+		virtual void Set(ShaderUniform<glm::mat4> uniform, const glm::mat4& value) override;
+
+		virtual const std::vector<ShaderUniformBlock>& GetUniformBlocks() const override { return mUniformBlocks; }
+
 		virtual const std::string& GetName() const override { return mName; }
+		virtual const std::string& GetFilepath() const override { return mFilepath; }
+
+		virtual bool CompileReload() override;
+		virtual bool FinishReload() override;
 
 		void UploadUniformInt(const std::string& name, int value) const;
 		void UploadUniformIntArray(const std::string& name, int* values, uint32_t count) const;
@@ -37,22 +58,60 @@ namespace Sora {
 		void UploadUniformMat3(const std::string& name, const glm::mat3& value) const;
 		void UploadUniformMat4(const std::string& name, const glm::mat4& value) const;
 	private:
+		struct DeferProgram {};
+		OpenGLShader(const std::string& filepath, DeferProgram);
+
+		struct StageStats
+		{
+			float Milliseconds = 0.0f;
+			bool VulkanCacheHit = false;
+			bool OpenGLCacheHit = false;
+			bool Compiled = false;
+		};
+
 		std::string ReadFile(const std::string& filepath);
 		std::unordered_map<GLenum, std::string> PreProcess(const std::string& source);
 
-		void CompileOrGetVulkanBinaries(const std::unordered_map<GLenum, std::string>& shader_sources);
-		void CompileOrGetOpenGLBinaries();
-		void CreateProgram();
+		// Everything up to the OpenGL SPIR-V, without touching GL state, so it may run on any thread. Only reads the
+		// program binary when the cache has one for these sources and this driver. Compilation and linking report
+		// errors through the log and their result, so that a failed reload keeps the current program.
+		bool Compile();
+		bool CompileStages();
+		bool CompileOrGetVulkanBinary(GLenum stage, const std::string& source, StageStats& stats);
+		bool CompileOrGetOpenGLBinary(GLenum stage, StageStats& stats);
+		bool CreateProgram();
+		bool LoadProgramBinary();
+		void SaveProgramBinary(uint32_t program);
 		void Reflect(GLenum stage, const std::vector<uint32_t>& shader_data);
+		// Builds the uniform tables from the linked program, which exists on every path, the program binary one included.
+		void ReflectProgram();
+		void LogCompileStats(float linkMilliseconds) const;
+		void ReportCompileFailure() const;
 	private:
-		uint32_t mRendererID;
+		uint32_t mRendererID = 0;
 		std::string mFilepath;
 		std::string mName;
 
+		std::unordered_map<GLenum, std::string> mShaderSources;
+		std::unordered_map<GLenum, StageStats> mStageStats;
+
+		std::string mProgramCachePath;
+		std::vector<uint8_t> mProgramBinary;	// Loaded by Compile(), consumed by CreateProgram().
+		bool mProgramFromBinary = false;
+
+		// Keyed by the hash of the uniform name. Names the program does not list are resolved through the driver once,
+		// and remembered with their result.
+		mutable std::unordered_map<uint64_t, int32_t> mUniformLocations;
+		std::vector<ShaderUniformBlock> mUniformBlocks;
+
 		std::unordered_map<GLenum, std::vector<uint32_t>> mVulkanSPIRV;
 		std::unordered_map<GLenum, std::vector<uint32_t>> mOpenGLSPIRV;
 
 		std::unordered_map<GLenum, std::string> mOpenGLSourceCode;
+
+		// Written by CompileReload() on the watcher thread, consumed by FinishReload() on the render thread.
+		Ref<OpenGLShader> mPendingReload;
+		bool mPendingReloadCompiled = false;
 	};
 
 }
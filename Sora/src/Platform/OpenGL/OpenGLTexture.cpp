@@ -1,26 +1,80 @@
 #include "sorapch.h"
 #include "OpenGLTexture.h"
 
-#include "stb_image.h"
+#include "Sora/Renderer/BlockCompression.h"
+
+// Core since OpenGL 4.2 for BC7, but BC1 and BC3 are only ever exposed as an extension.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+	#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT		0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+	#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT	0x83F3
+#endif
 
 namespace Sora {
 
-	OpenGLTexture2D::OpenGLTexture2D(uint32_t width, uint32_t height)
-		: m_Width(width), m_Height(height)
-	{
-		SORA_PROFILE_FUNCTION();
+	namespace Utils {
 
-		m_DataFormat = GL_RGBA;
-		m_InternalFormat = GL_RGBA8;
+		// The sized format the texture storage was actually allocated with.
+		static GLenum GetInternalFormat(uint32_t textureID)
+		{
+			GLint format = 0;
+			glGetTextureLevelParameteriv(textureID, 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+			return (GLenum)format;
+		}
 
-		glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
-		glTextureStorage2D(m_RendererID, 1, GL_RGB8, m_Width, m_Height);
+		static GLint GetLevelCount(uint32_t textureID)
+		{
+			GLint levels = 1;
+			glGetTextureParameteriv(textureID, GL_TEXTURE_IMMUTABLE_LEVELS, &levels);
+			return levels;
+		}
 
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		// Compressed formats have no separate data format, the one returned is never used.
+		static void GetGLFormats(TextureFormat format, GLenum& dataFormat, GLenum& internalFormat)
+		{
+			switch (format)
+			{
+			case TextureFormat::R8:
+				dataFormat = GL_RED;
+				internalFormat = GL_R8;
+				break;
+			case TextureFormat::RG8:
+				dataFormat = GL_RG;
+				internalFormat = GL_RG8;
+				break;
+			case TextureFormat::RGB8:
+				dataFormat = GL_RGB;
+				internalFormat = GL_RGB8;
+				break;
+			case TextureFormat::BC1:
+				dataFormat = GL_RGB;
+				internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+				break;
+			case TextureFormat::BC3:
+				dataFormat = GL_RGBA;
+				internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+				break;
+			case TextureFormat::BC7:
+				dataFormat = GL_RGBA;
+				internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+				break;
+			default:
+				dataFormat = GL_RGBA;
+				internalFormat = GL_RGBA8;
+				break;
+			}
+		}
 
-		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	}
+
+	OpenGLTexture2D::OpenGLTexture2D(uint32_t width, uint32_t height)
+		: m_Width(width), m_Height(height), m_Format(TextureFormat::RGBA8)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		CreateStorage();
+		glClearTexImage(m_RendererID, 0, m_DataFormat, GL_UNSIGNED_BYTE, nullptr);
 	}
 
 	OpenGLTexture2D::OpenGLTexture2D(const std::string& path)
@@ -28,53 +82,122 @@ namespace Sora {
 	{
 		SORA_PROFILE_FUNCTION();
 
-		int width, height, channels;
-		stbi_set_flip_vertically_on_load(1);
-		stbi_uc* data;
+		TextureImage image;
+		bool imported = TextureImporter::Import(path, image);
+		SORA_CORE_ASSERT(imported, "Failed to load image: {0}", path);
+		m_Width = image.Width;
+		m_Height = image.Height;
+		m_Format = image.Format;
+		m_LevelCount = (uint32_t)image.Levels.size();
+		m_Opaque = image.Opaque;
+
+		CreateStorage();
+
+		for (uint32_t level = 0; level < m_LevelCount; level++)
 		{
-			SORA_PROFILE_SCOPE("stbi_load() - OpenGLTexture2D::OpenGLTexture2D(const std::string&)");
-			data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+			const TextureImage::Level& data = image.Levels[level];
+			UploadRows(level, 0, TextureImporter::GetRowCount(m_Format, data.Height), image.GetData() + data.Offset, data.Size);
 		}
-		SORA_CORE_ASSERT(data, "Failed to load image: {0}", path);
-		m_Width = width;
-		m_Height = height;
+	}
+
+	OpenGLTexture2D::OpenGLTexture2D(const std::string& path, uint32_t width, uint32_t height, TextureFormat format, uint32_t levelCount)
+		: m_TexturePath(path), m_Width(width), m_Height(height), m_Format(format), m_LevelCount(levelCount), m_Loaded(false)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		CreateStorage();
+
+		// Only the smallest level is filled, with opaque grey, and sampled until the streamer has uploaded the ones
+		// above it. Compressed storage cannot be cleared, so the placeholder goes through the block encoder.
+		const uint32_t lastLevel = m_LevelCount - 1;
+		const uint32_t levelWidth = std::max(m_Width >> lastLevel, 1u);
+		const uint32_t levelHeight = std::max(m_Height >> lastLevel, 1u);
+		const uint8_t grey[4] = { 0x80, 0x80, 0x80, 0xFF };
+		if (TextureImporter::IsCompressed(m_Format))
+		{
+			uint8_t texels[16 * 4];
+			for (uint32_t i = 0; i < 16; i++)
+				memcpy(&texels[i * 4], grey, sizeof(grey));
+
+			uint8_t block[16];
+			switch (m_Format)
+			{
+			case TextureFormat::BC1:	BlockCompression::CompressBC1Block(texels, block); break;
+			case TextureFormat::BC3:	BlockCompression::CompressBC3Block(texels, block); break;
+			default:					BlockCompression::CompressBC7Block(texels, block); break;
+			}
 
-		switch (channels)
+			const uint32_t blockBytes = TextureImporter::GetRowBytes(m_Format, 1);
+			const uint32_t rowCount = TextureImporter::GetRowCount(m_Format, levelHeight);
+			const uint32_t rowBytes = TextureImporter::GetRowBytes(m_Format, levelWidth);
+			std::vector<uint8_t> placeholder((size_t)rowCount * rowBytes);
+			for (size_t offset = 0; offset < placeholder.size(); offset += blockBytes)
+				memcpy(placeholder.data() + offset, block, blockBytes);
+
+			UploadRows(lastLevel, 0, rowCount, placeholder.data(), placeholder.size());
+		}
+		else
 		{
-		case 1:
-			m_DataFormat = GL_RED;
-			m_InternalFormat = GL_R8;
-			break;
-		case 2:
-			m_DataFormat = GL_RG;
-			m_InternalFormat = GL_RG8;
-			break;
-		case 3:
-			m_DataFormat = GL_RGB;
-			m_InternalFormat = GL_RGB8;
-			break;
-		case 4:
-			m_DataFormat = GL_RGBA;
-			m_InternalFormat = GL_RGBA8;
-			break;
-		default:
-			m_DataFormat = GL_RGBA;
-			m_InternalFormat = GL_RGBA8;
-			break;
+			glClearTexImage(m_RendererID, lastLevel, GL_RGBA, GL_UNSIGNED_BYTE, grey);
 		}
-		
+
+		SetBaseLevel(lastLevel);
+	}
+
+	void OpenGLTexture2D::CreateStorage()
+	{
+		Utils::GetGLFormats(m_Format, m_DataFormat, m_InternalFormat);
+
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
-		glTextureStorage2D(m_RendererID, 1, m_InternalFormat, m_Width, m_Height);
+		glTextureStorage2D(m_RendererID, m_LevelCount, m_InternalFormat, m_Width, m_Height);
 
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST); 
+		SetParameters();
+	}
+
+	void OpenGLTexture2D::SetParameters()
+	{
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, m_LevelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
 		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	}
 
-		glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, GL_UNSIGNED_BYTE, data);
+	void OpenGLTexture2D::ViewArrayLayer(uint32_t arrayID, uint32_t layer)
+	{
+		// A view needs a name that has never been bound, which glCreateTextures() does not hand out.
+		GLuint view;
+		glGenTextures(1, &view);
+		glTextureView(view, GL_TEXTURE_2D, arrayID, m_InternalFormat, 0, m_LevelCount, layer, 1);
+
+		glDeleteTextures(1, &m_RendererID);
+		m_RendererID = view;
+		SetParameters();
+	}
+
+	void OpenGLTexture2D::UploadRows(uint32_t level, uint32_t firstRow, uint32_t rowCount, const void* data, size_t size)
+	{
+		const uint32_t levelWidth = std::max(m_Width >> level, 1u);
+		const uint32_t levelHeight = std::max(m_Height >> level, 1u);
 
-		stbi_image_free(data);
+		if (TextureImporter::IsCompressed(m_Format))
+		{
+			// Block rows are 4 texels high, the last one may be cut off by the edge of the level.
+			const uint32_t y = firstRow * 4;
+			const uint32_t height = std::min(rowCount * 4, levelHeight - y);
+			glCompressedTextureSubImage2D(m_RendererID, level, 0, y, levelWidth, height, m_InternalFormat, (GLsizei)size, data);
+			return;
+		}
+
+		// Rows of one and three channel images, and of small levels, are tightly packed.
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTextureSubImage2D(m_RendererID, level, 0, firstRow, levelWidth, rowCount, m_DataFormat, GL_UNSIGNED_BYTE, data);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+
+	void OpenGLTexture2D::SetBaseLevel(uint32_t level)
+	{
+		glTextureParameteri(m_RendererID, GL_TEXTURE_BASE_LEVEL, level);
 	}
 
 	OpenGLTexture2D::~OpenGLTexture2D()
@@ -90,6 +213,57 @@ namespace Sora {
 
 		//TODO: assert size = width * height * bpp
 		glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, GL_UNSIGNED_BYTE, data);
+		m_DataVersion++;
+
+		m_Opaque = true;
+		if (m_Format == TextureFormat::RGBA8)
+		{
+			const uint8_t* texels = (const uint8_t*)data;
+			const size_t texelCount = (size_t)m_Width * m_Height;
+			for (size_t i = 0; i < texelCount && m_Opaque; i++)
+				m_Opaque = texels[i * 4 + 3] == 0xFF;
+		}
+	}
+
+	bool OpenGLTexture2D::CopyFrom(const Texture2D& source, uint32_t x, uint32_t y)
+	{
+		return CopyFrom(source, 0, 0, source.GetWidth(), source.GetHeight(), x, y);
+	}
+
+	bool OpenGLTexture2D::CopyFrom(const Texture2D& source, uint32_t sourceX, uint32_t sourceY, uint32_t width, uint32_t height, uint32_t x, uint32_t y)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		SORA_CORE_ASSERT(sourceX + width <= source.GetWidth() && sourceY + height <= source.GetHeight(), "Copy region out of range!");
+		SORA_CORE_ASSERT(x + width <= m_Width && y + height <= m_Height, "Copy region out of range!");
+
+		GLenum sourceFormat = Utils::GetInternalFormat(source.GetRendererID());
+		if (sourceFormat == m_InternalFormat)
+		{
+			glCopyImageSubData(source.GetRendererID(), GL_TEXTURE_2D, 0, sourceX, sourceY, 0,
+				m_RendererID, GL_TEXTURE_2D, 0, x, y, 0,
+				width, height, 1);
+			return true;
+		}
+
+		// A blit converts between colour formats, but one or two channel data would come out tinted red.
+		if (sourceFormat != GL_RGB8 && sourceFormat != GL_RGBA8)
+			return false;
+
+		GLuint framebuffers[2];
+		glCreateFramebuffers(2, framebuffers);
+		glNamedFramebufferTexture(framebuffers[0], GL_COLOR_ATTACHMENT0, source.GetRendererID(), 0);
+		glNamedFramebufferTexture(framebuffers[1], GL_COLOR_ATTACHMENT0, m_RendererID, 0);
+		glNamedFramebufferReadBuffer(framebuffers[0], GL_COLOR_ATTACHMENT0);
+		glNamedFramebufferDrawBuffer(framebuffers[1], GL_COLOR_ATTACHMENT0);
+
+		glBlitNamedFramebuffer(framebuffers[0], framebuffers[1],
+			sourceX, sourceY, sourceX + width, sourceY + height,
+			x, y, x + width, y + height,
+			GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+		glDeleteFramebuffers(2, framebuffers);
+		return true;
 	}
 
 	void OpenGLTexture2D::Bind(uint32_t slot) const
@@ -99,4 +273,68 @@ namespace Sora {
 		glBindTextureUnit(slot, m_RendererID);
 	}
 
-}
\ No newline at end of file
+	OpenGLTexture2DArray::OpenGLTexture2DArray(const Texture2D& prototype, uint32_t layerCount)
+		: m_Width(prototype.GetWidth()), m_Height(prototype.GetHeight()), m_LayerCount(layerCount)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		m_InternalFormat = Utils::GetInternalFormat(prototype.GetRendererID());
+		m_LevelCount = Utils::GetLevelCount(prototype.GetRendererID());
+
+		glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_RendererID);
+		glTextureStorage3D(m_RendererID, m_LevelCount, m_InternalFormat, m_Width, m_Height, m_LayerCount);
+
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, m_LevelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	}
+
+	OpenGLTexture2DArray::~OpenGLTexture2DArray()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		glDeleteTextures(1, &m_RendererID);
+	}
+
+	void OpenGLTexture2DArray::SetData(void* data, uint32_t size)
+	{
+		SORA_CORE_ASSERT(false, "Texture2DArray layers are filled from textures, use SetLayer()!");
+	}
+
+	bool OpenGLTexture2DArray::CanHold(const Texture2D& texture) const
+	{
+		return texture.GetWidth() == m_Width && texture.GetHeight() == m_Height &&
+			Utils::GetInternalFormat(texture.GetRendererID()) == m_InternalFormat &&
+			Utils::GetLevelCount(texture.GetRendererID()) == m_LevelCount;
+	}
+
+	void OpenGLTexture2DArray::SetLayer(uint32_t layer, Texture2D& texture)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		SORA_CORE_ASSERT(layer < m_LayerCount, "Texture array layer out of range!");
+		SORA_CORE_ASSERT(CanHold(texture), "Texture does not match the texture array layout!");
+
+		// Every level, compressed ones included, copies as a whole so block alignment never comes into it.
+		for (GLint level = 0; level < m_LevelCount; level++)
+		{
+			glCopyImageSubData(texture.GetRendererID(), GL_TEXTURE_2D, level, 0, 0, 0,
+				m_RendererID, GL_TEXTURE_2D_ARRAY, level, 0, 0, layer,
+				std::max(m_Width >> level, 1u), std::max(m_Height >> level, 1u), 1);
+		}
+
+		// The texture gives up its own storage for the layer, which also carries any later SetData() over to it. Views
+		// share the storage of the array, which lives on for as long as any of them does.
+		((OpenGLTexture2D&)texture).ViewArrayLayer(m_RendererID, layer);
+	}
+
+	void OpenGLTexture2DArray::Bind(uint32_t slot) const
+	{
+		SORA_PROFILE_FUNCTION();
+
+		glBindTextureUnit(slot, m_RendererID);
+	}
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Sora/Renderer/Texture.h"
+#include "Sora/Renderer/TextureImporter.h"
 
 #include <filesystem>
 #include <glad/glad.h>
@@ -12,26 +13,87 @@ namespace Sora {
 	public:
 		OpenGLTexture2D(uint32_t width, uint32_t height);
 		OpenGLTexture2D(const std::string& path);
+		// Storage for an image that OpenGLTextureStreamer fills in later, showing a placeholder colour until then.
+		OpenGLTexture2D(const std::string& path, uint32_t width, uint32_t height, TextureFormat format, uint32_t levelCount);
 		virtual ~OpenGLTexture2D();
 
 		virtual uint32_t GetWidth() const override { return m_Width; }
 		virtual uint32_t GetHeight() const override { return m_Height; }
 		virtual uint32_t GetRendererID() const override { return m_RendererID; }
 		virtual const std::filesystem::path& GetTexturePath() const override { return m_TexturePath; }
+		virtual bool IsLoaded() const override { return m_Loaded; }
+		virtual TextureFormat GetFormat() const override { return m_Format; }
+		virtual uint32_t GetLevelCount() const override { return m_LevelCount; }
+		virtual uint32_t GetDataVersion() const override { return m_DataVersion; }
+		virtual bool IsOpaque() const override { return m_Opaque; }
 
 		virtual void SetData(void* data, uint32_t size) override;
 
+		virtual bool CopyFrom(const Texture2D& source, uint32_t x, uint32_t y) override;
+		virtual bool CopyFrom(const Texture2D& source, uint32_t sourceX, uint32_t sourceY, uint32_t width, uint32_t height, uint32_t x, uint32_t y) override;
+
 		virtual void Bind(uint32_t slot = 0) const override;
 
 		virtual bool operator==(const Texture& other) const override
 		{
 			return m_RendererID == ((OpenGLTexture2D&)other).m_RendererID;
 		}
+	private:
+		void CreateStorage();
+		void SetParameters();
+		// Releases the storage of this texture and makes it a view of one layer of a texture array of the same format
+		// and levels. The renderer ID changes.
+		void ViewArrayLayer(uint32_t arrayID, uint32_t layer);
+		// Rows are those of TextureImporter: pixel rows, or rows of blocks for compressed formats. With a pixel unpack
+		// buffer bound, 'data' is an offset into it.
+		void UploadRows(uint32_t level, uint32_t firstRow, uint32_t rowCount, const void* data, size_t size);
+		// Levels above 'level' are not sampled, while they are still being uploaded.
+		void SetBaseLevel(uint32_t level);
 	private:
 		std::filesystem::path m_TexturePath;
 		uint32_t m_Width, m_Height;
 		uint32_t m_RendererID;
+		TextureFormat m_Format;
+		uint32_t m_LevelCount = 1;
 		GLenum m_DataFormat, m_InternalFormat;
+		uint32_t m_DataVersion = 0;
+		bool m_Loaded = true;
+		bool m_Opaque = false;
+
+		friend class OpenGLTextureStreamer;
+		friend class OpenGLTexture2DArray;
+	};
+
+	class OpenGLTexture2DArray : public Texture2DArray
+	{
+	public:
+		OpenGLTexture2DArray(const Texture2D& prototype, uint32_t layerCount);
+		virtual ~OpenGLTexture2DArray();
+
+		virtual uint32_t GetWidth() const override { return m_Width; }
+		virtual uint32_t GetHeight() const override { return m_Height; }
+		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+		virtual const std::filesystem::path& GetTexturePath() const override { return m_TexturePath; }
+		virtual bool IsLoaded() const override { return true; }
+		virtual uint32_t GetLayerCount() const override { return m_LayerCount; }
+
+		virtual void SetData(void* data, uint32_t size) override;
+
+		virtual bool CanHold(const Texture2D& texture) const override;
+		virtual void SetLayer(uint32_t layer, Texture2D& texture) override;
+
+		virtual void Bind(uint32_t slot = 0) const override;
+
+		virtual bool operator==(const Texture& other) const override
+		{
+			return m_RendererID == other.GetRendererID();
+		}
+	private:
+		std::filesystem::path m_TexturePath;
+		uint32_t m_Width, m_Height, m_LayerCount;
+		uint32_t m_RendererID;
+		GLenum m_InternalFormat;
+		GLint m_LevelCount;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,304 @@
+#include "sorapch.h"
+#include "OpenGLTextureStreamer.h"
+
+#include "OpenGLTexture.h"
+
+#include "Sora/Core/JobSystem.h"
+
+#include "stb_image.h"
+#include <glad/glad.h>
+
+namespace Sora {
+
+	OpenGLTextureStreamer::OpenGLTextureStreamer()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		// Decoding is mostly inflate and file reads, a few threads are plenty and leave the rest of the cores alone.
+		uint32_t workerCount = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+		for (uint32_t i = 0; i < workerCount; i++)
+			m_Workers.emplace_back([this]() { RunWorker(); });
+
+		CreateUploadBuffer();
+	}
+
+	OpenGLTextureStreamer::~OpenGLTextureStreamer()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Running = false;
+		}
+		m_WorkAvailable.notify_all();
+
+		for (std::thread& worker : m_Workers)
+			worker.join();
+
+		DestroyUploadBuffer();
+	}
+
+	Ref<Texture2D> OpenGLTextureStreamer::Load(const std::string& path, uint32_t thumbnailSize /*= 0*/)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		int width, height, channels;
+		if (!stbi_info(path.c_str(), &width, &height, &channels))
+		{
+			SORA_CORE_ERROR("Failed to load image: {0}", path);
+			return nullptr;
+		}
+
+		Ref<OpenGLTexture2D> texture;
+		if (thumbnailSize)
+		{
+			uint32_t thumbnailWidth, thumbnailHeight;
+			TextureImporter::GetThumbnailSize((uint32_t)width, (uint32_t)height, thumbnailSize, thumbnailWidth, thumbnailHeight);
+			texture = CreateRef<OpenGLTexture2D>(path, thumbnailWidth, thumbnailHeight, TextureFormat::RGBA8, 1);
+		}
+		else
+		{
+			texture = CreateRef<OpenGLTexture2D>(path, (uint32_t)width, (uint32_t)height,
+				TextureImporter::GetImportFormat((uint32_t)channels),
+				TextureImporter::GetImportLevelCount((uint32_t)width, (uint32_t)height));
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Requests.push_back({ texture, path, thumbnailSize });
+		}
+		m_WorkAvailable.notify_one();
+
+		return texture;
+	}
+
+	void OpenGLTextureStreamer::RunWorker()
+	{
+		SORA_PROFILE_THREAD("Texture Streamer");
+
+		// Block compression of streamed textures must not hold up threads waiting on frame work.
+		JobSystem::SetThreadPriority(JobPriority::Background);
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		while (true)
+		{
+			m_WorkAvailable.wait(lock, [this]() { return !m_Running || !m_Requests.empty(); });
+			if (!m_Running)
+				return;
+
+			Request request = std::move(m_Requests.front());
+			m_Requests.pop_front();
+
+			// Textures released before their turn are not decoded at all. Workers never lock the texture, so the last
+			// reference, and with it the GL object, is always released on the render thread.
+			if (request.Texture.expired())
+				continue;
+
+			m_DecodingCount++;
+			lock.unlock();
+
+			DecodedImage decoded;
+			decoded.Texture = request.Texture;
+			decoded.Imported = request.ThumbnailSize ? TextureImporter::ImportThumbnail(request.Path, request.ThumbnailSize, decoded.Image) :
+				TextureImporter::Import(request.Path, decoded.Image);
+			if (decoded.Imported)
+			{
+				decoded.Level = (uint32_t)decoded.Image.Levels.size() - 1;
+
+				// Faults the pages of a mapped texture file in here, not in the middle of the uploads on the render thread.
+				if (decoded.Image.File)
+				{
+					volatile uint8_t sink = 0;
+					const uint8_t* data = decoded.Image.File->GetData();
+					for (size_t offset = 0; offset < decoded.Image.File->GetSize(); offset += 4096)
+						sink += data[offset];
+				}
+			}
+			else
+				SORA_CORE_ERROR("Failed to load image: {0}", request.Path);
+
+			lock.lock();
+			m_DecodingCount--;
+			m_Decoded.push_back(std::move(decoded));
+		}
+	}
+
+	void OpenGLTextureStreamer::CreateUploadBuffer()
+	{
+		m_BufferRegionSize = m_UploadBudget;
+
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferStorage(m_RendererID, (GLsizeiptr)m_BufferRegionSize * RegionCount, nullptr, flags);
+		m_MappedData = (uint8_t*)glMapNamedBufferRange(m_RendererID, 0, (GLsizeiptr)m_BufferRegionSize * RegionCount, flags);
+		m_RegionIndex = 0;
+	}
+
+	void OpenGLTextureStreamer::DestroyUploadBuffer()
+	{
+		for (GLsync& fence : m_RegionFences)
+		{
+			if (fence)
+				glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		if (m_MappedData)
+			glUnmapNamedBuffer(m_RendererID);
+		m_MappedData = nullptr;
+
+		glDeleteBuffers(1, &m_RendererID);
+		m_RendererID = 0;
+	}
+
+	void OpenGLTextureStreamer::SetUploadBudget(uint32_t bytes)
+	{
+		// The buffer is resized by the next OnUpdate().
+		m_UploadBudget = std::max(bytes, 64u * 1024u);
+	}
+
+	uint32_t OpenGLTextureStreamer::UploadRows(DecodedImage& decoded, OpenGLTexture2D& texture, uint32_t regionOffset, uint32_t available)
+	{
+		const TextureImage::Level& level = decoded.Image.Levels[decoded.Level];
+		const uint32_t rowBytes = TextureImporter::GetRowBytes(decoded.Image.Format, level.Width);
+		const uint32_t remainingRows = TextureImporter::GetRowCount(decoded.Image.Format, level.Height) - decoded.UploadedRows;
+		const uint32_t rows = std::min(remainingRows, available / rowBytes);
+		if (rows == 0)
+			return 0;
+
+		const uint32_t bytes = rows * rowBytes;
+		memcpy(m_MappedData + regionOffset, decoded.Image.GetData() + level.Offset + (size_t)decoded.UploadedRows * rowBytes, bytes);
+
+		// With a pixel unpack buffer bound, the data pointer is an offset into it.
+		texture.UploadRows(decoded.Level, decoded.UploadedRows, rows, (const void*)(uintptr_t)regionOffset, bytes);
+
+		decoded.UploadedRows += rows;
+		return bytes;
+	}
+
+	void OpenGLTextureStreamer::OnUpdate()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		m_UploadedBytes = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			while (!m_Decoded.empty())
+			{
+				m_Uploads.push_back(std::move(m_Decoded.front()));
+				m_Decoded.pop_front();
+			}
+		}
+
+		if (m_Uploads.empty())
+			return;
+
+		if (m_UploadBudget != m_BufferRegionSize)
+		{
+			glFinish();
+			DestroyUploadBuffer();
+			CreateUploadBuffer();
+		}
+
+		GLsync& fence = m_RegionFences[m_RegionIndex];
+		if (fence)
+		{
+			SORA_PROFILE_SCOPE("OpenGLTextureStreamer::OnUpdate - wait");
+
+			GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+			while (result == GL_TIMEOUT_EXPIRED)
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_RendererID);
+
+		const uint32_t regionStart = m_RegionIndex * m_BufferRegionSize;
+		uint32_t used = 0;
+		while (!m_Uploads.empty())
+		{
+			DecodedImage& decoded = m_Uploads.front();
+			auto texture = decoded.Texture.lock();
+
+			// The storage was allocated from the header, a file changed in between cannot be uploaded into it.
+			const TextureImage& image = decoded.Image;
+			if (texture && decoded.Imported && (image.Width != texture->m_Width || image.Height != texture->m_Height ||
+				image.Format != texture->m_Format || image.Levels.size() != texture->m_LevelCount))
+			{
+				SORA_CORE_ERROR("Image changed while loading: {0}", texture->m_TexturePath.string());
+				decoded.Imported = false;
+			}
+
+			if (!texture || !decoded.Imported)
+			{
+				// Failed images keep their placeholder for good.
+				m_Uploads.pop_front();
+				continue;
+			}
+
+			const TextureImage::Level& level = image.Levels[decoded.Level];
+			const uint32_t rowCount = TextureImporter::GetRowCount(image.Format, level.Height);
+			if (TextureImporter::GetRowBytes(image.Format, level.Width) > m_BufferRegionSize)
+			{
+				// Wider than a whole region, which only tiny budgets run into. Uploaded straight from memory.
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				texture->UploadRows(decoded.Level, 0, rowCount, image.GetData() + level.Offset, level.Size);
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_RendererID);
+
+				used = m_BufferRegionSize;
+				decoded.UploadedRows = rowCount;
+			}
+			else
+			{
+				uint32_t bytes = UploadRows(decoded, *texture, regionStart + used, m_BufferRegionSize - used);
+				if (bytes == 0)
+					break;
+
+				used += bytes;
+			}
+
+			if (decoded.UploadedRows < rowCount)
+				continue;
+
+			texture->SetBaseLevel(decoded.Level);
+			if (decoded.Level > 0)
+			{
+				decoded.Level--;
+				decoded.UploadedRows = 0;
+				continue;
+			}
+
+			texture->m_Loaded = true;
+			texture->m_Opaque = image.Opaque;
+			m_LoadedCount++;
+			m_Uploads.pop_front();
+		}
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		m_UploadedBytes = used;
+		if (used > 0)
+		{
+			fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			m_RegionIndex = (m_RegionIndex + 1) % RegionCount;
+		}
+	}
+
+	TextureStreamer::Statistics OpenGLTextureStreamer::GetStats() const
+	{
+		Statistics stats;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			stats.PendingDecodes = (uint32_t)m_Requests.size() + m_DecodingCount;
+			stats.PendingUploads = (uint32_t)m_Decoded.size();
+		}
+		stats.PendingUploads += (uint32_t)m_Uploads.size();
+		stats.UploadedBytes = m_UploadedBytes;
+		stats.LoadedCount = m_LoadedCount;
+		return stats;
+	}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Sora/Renderer/TextureStreamer.h"
+#include "Sora/Renderer/TextureImporter.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+typedef struct __GLsync* GLsync;
+
+namespace Sora {
+
+	class OpenGLTexture2D;
+
+	// Uploads go through a persistently mapped pixel unpack buffer split into one region per frame in flight, each the
+	// size of the upload budget. Images bigger than what is left of a region are uploaded a band of rows at a time.
+	// Mip levels go smallest first, and each is sampled as soon as it is complete, so textures sharpen as they arrive.
+	class OpenGLTextureStreamer : public TextureStreamer
+	{
+	public:
+		OpenGLTextureStreamer();
+		virtual ~OpenGLTextureStreamer();
+
+		virtual Ref<Texture2D> Load(const std::string& path, uint32_t thumbnailSize = 0) override;
+
+		virtual void OnUpdate() override;
+
+		virtual void SetUploadBudget(uint32_t bytes) override;
+		virtual uint32_t GetUploadBudget() const override { return m_UploadBudget; }
+
+		virtual Statistics GetStats() const override;
+	private:
+		struct Request
+		{
+			std::weak_ptr<OpenGLTexture2D> Texture;
+			std::string Path;
+			uint32_t ThumbnailSize = 0;
+		};
+
+		struct DecodedImage
+		{
+			std::weak_ptr<OpenGLTexture2D> Texture;
+			TextureImage Image;
+			bool Imported = false;
+			uint32_t Level = 0;			// Being uploaded, counting down to 0.
+			uint32_t UploadedRows = 0;	// Of that level.
+		};
+
+		void RunWorker();
+		void CreateUploadBuffer();
+		void DestroyUploadBuffer();
+		// Returns the bytes taken from the region, or 0 when not even one row fits.
+		uint32_t UploadRows(DecodedImage& decoded, OpenGLTexture2D& texture, uint32_t regionOffset, uint32_t available);
+	private:
+		static const uint32_t RegionCount = 3;
+
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_WorkAvailable;
+		bool m_Running = true;
+		std::deque<Request> m_Requests;
+		std::deque<DecodedImage> m_Decoded;
+		uint32_t m_DecodingCount = 0;
+		std::vector<std::thread> m_Workers;
+
+		// Render thread only.
+		std::deque<DecodedImage> m_Uploads;
+		uint32_t m_UploadBudget = 4 * 1024 * 1024;
+		uint32_t m_BufferRegionSize = 0;
+		uint32_t m_RendererID = 0;
+		uint8_t* m_MappedData = nullptr;
+		std::array<GLsync, RegionCount> m_RegionFences = {};
+		uint32_t m_RegionIndex = 0;
+
+		uint32_t m_UploadedBytes = 0;
+		uint32_t m_LoadedCount = 0;
+	};
+
+}
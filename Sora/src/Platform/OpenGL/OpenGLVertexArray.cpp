@@ -20,6 +20,8 @@ namespace Sora {
 			case ShaderDataType::Int2:		return GL_INT;
 			case ShaderDataType::Int3:		return GL_INT;
 			case ShaderDataType::Int4:		return GL_INT;
+			case ShaderDataType::UInt:		return GL_UNSIGNED_INT;
+			case ShaderDataType::UInt2:		return GL_UNSIGNED_INT;
 			case ShaderDataType::Bool:		return GL_BOOL;
 		}
 
@@ -58,6 +60,19 @@ namespace Sora {
 	void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertex_buffer)
 	{
 		SORA_PROFILE_FUNCTION();
+
+		AddBuffer(vertex_buffer, 0);
+	}
+
+	void OpenGLVertexArray::AddInstanceBuffer(const Ref<VertexBuffer>& instance_buffer)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		AddBuffer(instance_buffer, 1);
+	}
+
+	void OpenGLVertexArray::AddBuffer(const Ref<VertexBuffer>& vertex_buffer, uint32_t divisor)
+	{
 		SORA_CORE_ASSERT(vertex_buffer->GetLayout().GetElements().size(), "Vertex Buffer has no layout!");
 
 		glBindVertexArray(mRendererID);
@@ -82,6 +97,7 @@ namespace Sora {
 						layout.GetStride(),
 						(const void*)element.Offset
 					);
+					glVertexAttribDivisor(mVertexBufferIndex, divisor);
 					mVertexBufferIndex++;
 					break;
 				}
@@ -111,6 +127,8 @@ namespace Sora {
 				case ShaderDataType::Int2:
 				case ShaderDataType::Int3:
 				case ShaderDataType::Int4:
+				case ShaderDataType::UInt:
+				case ShaderDataType::UInt2:
 				case ShaderDataType::Bool:
 				{
 					glEnableVertexAttribArray(mVertexBufferIndex);
@@ -121,6 +139,7 @@ namespace Sora {
 						layout.GetStride(),
 						(const void*)element.Offset
 					);
+					glVertexAttribDivisor(mVertexBufferIndex, divisor);
 					mVertexBufferIndex++;
 					break;
 				}
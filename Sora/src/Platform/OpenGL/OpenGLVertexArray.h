@@ -14,10 +14,13 @@ namespace Sora {
 		virtual void Unbind() const override;
 
 		virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) override;
+		virtual void AddInstanceBuffer(const Ref<VertexBuffer>& instanceBuffer) override;
 		virtual void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) override;
 
 		virtual const std::vector<Ref<VertexBuffer>>& GetVertexBuffer() const { return mVertexBuffers; }
 		virtual const Ref<IndexBuffer>& GetIndexBuffer() const { return mIndexBuffer; }
+	private:
+		void AddBuffer(const Ref<VertexBuffer>& buffer, uint32_t divisor);
 	private:
 		uint32_t mRendererID;
 		uint32_t mVertexBufferIndex = 0;
@@ -74,4 +74,35 @@ namespace Sora {
 		return std::string();
 	}
 
+	MappedFile::MappedFile(const std::filesystem::path& path)
+	{
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return;
+
+		m_FileHandle = file;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+			return;
+
+		m_MappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_MappingHandle)
+			return;
+
+		m_Data = (const uint8_t*)MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+		if (m_Data)
+			m_Size = (size_t)size.QuadPart;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_Data)
+			UnmapViewOfFile(m_Data);
+		if (m_MappingHandle)
+			CloseHandle(m_MappingHandle);
+		if (m_FileHandle)
+			CloseHandle(m_FileHandle);
+	}
+
 }
\ No newline at end of file
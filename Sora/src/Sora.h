@@ -6,6 +6,7 @@
 #include "Sora/Core/Log.h"
 
 #include "Sora/Core/Timestep.h"
+#include "Sora/Core/JobSystem.h"
 
 #include "Sora/Core/Input.h"
 #include "Sora/Core/KeyCodes.h"
@@ -28,7 +29,9 @@
 #include "Sora/Renderer/Buffer.h"
 #include "Sora/Renderer/Shader.h"
 #include "Sora/Renderer/Framebuffer.h"
+#include "Sora/Renderer/RenderGraph.h"
 #include "Sora/Renderer/Texture.h"
+#include "Sora/Renderer/TextureAtlas.h"
 #include "Sora/Renderer/VertexArray.h"
 
 #include "Sora/Renderer/OrthographicCamera.h"
@@ -1,6 +1,7 @@
 #include "sorapch.h"
 #include "Application.h"
 
+#include "Sora/Core/JobSystem.h"
 #include "Sora/Renderer/Renderer.h"
 
 #include "Input.h"
@@ -25,6 +26,7 @@ namespace Sora {
 		m_Window = Window::Create(WindowProps(name));
 		m_Window->SetEventCallback(BIND_EVENT_FN(OnEvent));
 
+		JobSystem::Init();
 		Renderer::Init();
 
 		m_ImGuiLayer = new ImGuiLayer();
@@ -36,6 +38,7 @@ namespace Sora {
 		SORA_PROFILE_FUNCTION();
 
 		Renderer::Shutdown();
+		JobSystem::Shutdown();
 	}
 
 	void Application::PushLayer(Layer* layer)
@@ -85,6 +88,9 @@ namespace Sora {
 			Timestep timestep = time - m_LastFrameTime;
 			m_LastFrameTime = time;
 
+			Renderer::GetTextureStreamer().OnUpdate();
+			Renderer::GetRenderTargetPool()->OnUpdate();
+
 			if (!m_Minimized)
 			{
 				{
@@ -0,0 +1,244 @@
+#include "sorapch.h"
+#include "JobSystem.h"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace Sora {
+
+	struct JobQueue
+	{
+		std::mutex Mutex;
+		std::deque<Job> Jobs;
+	};
+
+	struct JobSystemData
+	{
+		// Queue 0 is shared by the threads that are not workers, worker i owns queue i + 1.
+		std::vector<Scope<JobQueue>> Queues;
+		JobQueue BackgroundQueue;
+		std::vector<std::thread> Workers;
+
+		std::atomic<uint32_t> QueuedJobCount = 0;	// In Queues.
+		std::atomic<uint32_t> BackgroundJobCount = 0;
+		std::mutex SleepMutex;
+		std::condition_variable WorkAvailable;
+		bool Running = false;
+	};
+
+	static JobSystemData* s_Data = nullptr;
+
+	static thread_local uint32_t s_QueueIndex = 0;
+	// Of the job running on this thread, or the one set for the thread outside of jobs.
+	static thread_local JobPriority s_Priority = JobPriority::Normal;
+
+	void JobSystem::Init(uint32_t workerCount /*= 0*/)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		SORA_CORE_ASSERT(!s_Data, "JobSystem already initialized!");
+		s_Data = new JobSystemData();
+
+		if (workerCount == 0)
+			workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+		for (uint32_t i = 0; i <= workerCount; i++)
+			s_Data->Queues.push_back(CreateScope<JobQueue>());
+
+		s_Data->Running = true;
+		for (uint32_t i = 1; i <= workerCount; i++)
+			s_Data->Workers.emplace_back([i]() { RunWorker(i); });
+
+		SORA_CORE_INFO("JobSystem: {0} workers", workerCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		{
+			std::lock_guard<std::mutex> lock(s_Data->SleepMutex);
+			s_Data->Running = false;
+		}
+		s_Data->WorkAvailable.notify_all();
+
+		for (std::thread& worker : s_Data->Workers)
+			worker.join();
+
+		SORA_CORE_ASSERT(s_Data->QueuedJobCount == 0 && s_Data->BackgroundJobCount == 0, "Jobs left in the queues at shutdown!");
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return (uint32_t)s_Data->Workers.size();
+	}
+
+	void JobSystem::SetThreadPriority(JobPriority priority)
+	{
+		s_Priority = priority;
+	}
+
+	void JobSystem::Run(std::function<void()> function, JobCounter* counter /*= nullptr*/, JobCounter* dependency /*= nullptr*/)
+	{
+		SORA_CORE_ASSERT(s_Data, "JobSystem not initialized!");
+
+		if (counter)
+			counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+		Job job = { std::move(function), counter, s_Priority };
+		if (dependency)
+		{
+			// The job that takes the dependency to zero queues its continuations under the same lock.
+			std::lock_guard<std::mutex> lock(dependency->m_Mutex);
+			if (!dependency->IsDone())
+			{
+				dependency->m_Continuations.push_back(std::move(job));
+				return;
+			}
+		}
+
+		Enqueue(std::move(job));
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		while (!counter.IsDone())
+		{
+			if (!TryRunJob())
+				std::this_thread::yield();
+		}
+
+		// The last job may still hold the lock, right after taking the counter to zero.
+		std::lock_guard<std::mutex> lock(counter.m_Mutex);
+	}
+
+	bool JobSystem::TryRunJob()
+	{
+		Job job;
+		if (!TryGetJob(job, s_Priority == JobPriority::Background))
+			return false;
+
+		Execute(job);
+		return true;
+	}
+
+	void JobSystem::Enqueue(Job&& job)
+	{
+		const bool background = job.Priority == JobPriority::Background;
+		JobQueue& queue = background ? s_Data->BackgroundQueue : *s_Data->Queues[s_QueueIndex];
+		{
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			queue.Jobs.push_back(std::move(job));
+		}
+
+		(background ? s_Data->BackgroundJobCount : s_Data->QueuedJobCount).fetch_add(1, std::memory_order_release);
+		{
+			// Taking the lock orders this with a worker that just found nothing and is about to sleep.
+			std::lock_guard<std::mutex> lock(s_Data->SleepMutex);
+		}
+		s_Data->WorkAvailable.notify_one();
+	}
+
+	bool JobSystem::TryGetJob(Job& o_Job, bool background)
+	{
+		if (s_Data->QueuedJobCount.load(std::memory_order_acquire) == 0)
+		{
+			if (!background || s_Data->BackgroundJobCount.load(std::memory_order_acquire) == 0)
+				return false;
+
+			// Oldest first, like stealing: the background queue is shared by every thread that may run it.
+			JobQueue& queue = s_Data->BackgroundQueue;
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			if (queue.Jobs.empty())
+				return false;
+
+			o_Job = std::move(queue.Jobs.front());
+			queue.Jobs.pop_front();
+			s_Data->BackgroundJobCount.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		// Newest first from the own queue, then oldest first from the others, starting with the next one so that
+		// thieves spread over the queues.
+		const uint32_t queueCount = (uint32_t)s_Data->Queues.size();
+		for (uint32_t i = 0; i < queueCount; i++)
+		{
+			const uint32_t queueIndex = (s_QueueIndex + i) % queueCount;
+			JobQueue& queue = *s_Data->Queues[queueIndex];
+
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			if (queue.Jobs.empty())
+				continue;
+
+			if (i == 0)
+			{
+				o_Job = std::move(queue.Jobs.back());
+				queue.Jobs.pop_back();
+			}
+			else
+			{
+				o_Job = std::move(queue.Jobs.front());
+				queue.Jobs.pop_front();
+			}
+
+			s_Data->QueuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		return false;
+	}
+
+	void JobSystem::Execute(Job& job)
+	{
+		// Jobs queued and waited on from inside this one take its priority.
+		const JobPriority previousPriority = s_Priority;
+		s_Priority = job.Priority;
+		job.Function();
+		s_Priority = previousPriority;
+
+		JobCounter* counter = job.Counter;
+		if (!counter)
+			return;
+
+		std::vector<Job> continuations;
+		{
+			std::lock_guard<std::mutex> lock(counter->m_Mutex);
+			if (counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				continuations.swap(counter->m_Continuations);
+		}
+
+		// The counter may be gone by now, a waiter is free to destroy it once it is done.
+		for (Job& continuation : continuations)
+			Enqueue(std::move(continuation));
+	}
+
+	void JobSystem::RunWorker(uint32_t queueIndex)
+	{
+		s_QueueIndex = queueIndex;
+
+		SORA_PROFILE_THREAD("Job Worker " + std::to_string(queueIndex));
+
+		while (true)
+		{
+			// Workers take background jobs, but only once the other queues are empty.
+			Job job;
+			if (TryGetJob(job, true))
+			{
+				Execute(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(s_Data->SleepMutex);
+			s_Data->WorkAvailable.wait(lock, []() { return !s_Data->Running || s_Data->QueuedJobCount > 0 || s_Data->BackgroundJobCount > 0; });
+			if (!s_Data->Running)
+				return;
+		}
+	}
+
+}
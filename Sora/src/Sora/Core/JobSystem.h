@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Sora/Core/Core.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Sora {
+
+	class JobCounter;
+
+	// Background jobs, such as texture compression for the streamer, only run on workers with nothing else to do and on
+	// background threads. A thread waiting on frame work never picks one up, so it cannot get stuck behind one.
+	enum class JobPriority
+	{
+		Normal = 0, Background
+	};
+
+	struct Job
+	{
+		std::function<void()> Function;
+		JobCounter* Counter = nullptr;
+		JobPriority Priority = JobPriority::Normal;
+	};
+
+	// Counts the jobs run with it that have not finished yet. Jobs can also be made to wait for one, and are then only
+	// queued once it reaches zero. A counter must outlive its jobs: JobSystem::Wait() on it before destroying it.
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+	private:
+		std::atomic<uint32_t> m_Pending = 0;
+
+		std::mutex m_Mutex;
+		std::vector<Job> m_Continuations;
+
+		friend class JobSystem;
+	};
+
+	// A fixed pool of worker threads, one fewer than there are cores, as the thread that waits on a counter runs jobs
+	// too. Every worker has its own queue: it takes the jobs it queued itself newest first, while they are still in
+	// cache, and steals the oldest from the others when it runs out. Threads that are not workers, the main thread and
+	// the texture streamer's, share one more queue. Background jobs have a queue of their own.
+	class JobSystem
+	{
+	public:
+		static void Init(uint32_t workerCount = 0);
+		static void Shutdown();
+
+		static uint32_t GetWorkerCount();
+
+		// The priority of the jobs the calling thread queues, for threads that are not workers. Jobs queue theirs
+		// with the priority they run at, so a background job that splits itself up stays in the background.
+		static void SetThreadPriority(JobPriority priority);
+
+		// Queues 'function', right away or once 'dependency' is done. 'counter' counts it from now on.
+		static void Run(std::function<void()> function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+		// Runs queued jobs until the counter is done, so waiting from a job cannot run out of workers. Background jobs
+		// are only among them when waiting at background priority.
+		static void Wait(JobCounter& counter);
+		// Runs one queued job, if there is one, and returns whether it did. For threads waiting on something other
+		// than a counter.
+		static bool TryRunJob();
+
+		// Calls function(begin, end) over [0, count) in chunks of 'grainSize', and returns once all of them are done.
+		// The calling thread takes the first chunk.
+		template<typename Function>
+		static void ParallelFor(size_t count, size_t grainSize, const Function& function)
+		{
+			if (count <= grainSize)
+			{
+				if (count > 0)
+					function(0, count);
+				return;
+			}
+
+			JobCounter counter;
+			for (size_t begin = grainSize; begin < count; begin += grainSize)
+			{
+				const size_t end = std::min(count, begin + grainSize);
+				Run([&function, begin, end]() { function(begin, end); }, &counter);
+			}
+
+			function(0, grainSize);
+			Wait(counter);
+		}
+
+		// Calls function(entity) for every entity of an entt view, split into chunks of its leading storage. The
+		// function may only write components of the entity it is given, and must not add or remove components.
+		template<typename View, typename Function>
+		static void ParallelForEach(const View& view, size_t grainSize, const Function& function)
+		{
+			const auto* storage = view.handle();
+			if (!storage)
+				return;
+
+			ParallelFor(storage->size(), grainSize, [&](size_t begin, size_t end)
+				{
+					const auto* entities = storage->data();
+					for (size_t i = begin; i < end; i++)
+					{
+						if (view.contains(entities[i]))
+							function(entities[i]);
+					}
+				});
+		}
+	private:
+		static void Enqueue(Job&& job);
+		static bool TryGetJob(Job& o_Job, bool background);
+		static void Execute(Job& job);
+		static void RunWorker(uint32_t queueIndex);
+	};
+
+}
@@ -4,6 +4,8 @@
 #include <chrono>
 #include <algorithm>
 #include <fstream>
+#include <mutex>
+#include <map>
 
 #include <thread>
 
@@ -20,12 +22,16 @@ namespace Sora {
 		std::string Name;
 	};
 
+	// Profiles are written from any thread, the job system's workers included, and named in the trace when the
+	// thread was given a name.
 	class Instrumentor
 	{
 	private:
 		InstrumentationSession* m_CurrentSession;
 		std::ofstream m_OutputStream;
 		int m_ProfileCount;
+		std::mutex m_Mutex;
+		std::map<size_t, std::string> m_ThreadNames;
 	public:
 		Instrumentor()
 			: m_CurrentSession(nullptr), m_ProfileCount(0)
@@ -34,13 +40,18 @@ namespace Sora {
 
 		void BeginSession(const std::string& name, const std::string& filepath = "results.json")
 		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
 			m_OutputStream.open(filepath);
 			WriteHeader();
 			m_CurrentSession = new InstrumentationSession{ name };
+
+			for (const auto& [threadID, threadName] : m_ThreadNames)
+				WriteThreadName(threadID, threadName);
 		}
 
 		void EndSession()
 		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
 			WriteFooter();
 			m_OutputStream.close();
 			delete m_CurrentSession;
@@ -50,6 +61,10 @@ namespace Sora {
 
 		void WriteProfile(const ProfileResult& result)
 		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (!m_CurrentSession)
+				return;
+
 			if (m_ProfileCount++ > 0)
 				m_OutputStream << ",";
 
@@ -69,6 +84,38 @@ namespace Sora {
 			m_OutputStream.flush();
 		}
 
+		// Names the calling thread, in this session and the ones after it.
+		void SetThreadName(const std::string& name)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			size_t threadID = GetThreadID();
+			m_ThreadNames[threadID] = name;
+
+			if (m_CurrentSession)
+				WriteThreadName(threadID, name);
+		}
+
+		static size_t GetThreadID()
+		{
+			return std::hash<std::thread::id>{}(std::this_thread::get_id());
+		}
+
+		void WriteThreadName(size_t threadID, const std::string& name)
+		{
+			if (m_ProfileCount++ > 0)
+				m_OutputStream << ",";
+
+			m_OutputStream << "{";
+			m_OutputStream << "\"name\":\"thread_name\",";
+			m_OutputStream << "\"ph\":\"M\",";
+			m_OutputStream << "\"pid\":0,";
+			m_OutputStream << "\"tid\":" << threadID << ",";
+			m_OutputStream << "\"args\":{\"name\":\"" << name << "\"}";
+			m_OutputStream << "}";
+
+			m_OutputStream.flush();
+		}
+
 		void WriteHeader()
 		{
 			m_OutputStream << "{\"otherData\": {},\"traceEvents\":[";
@@ -110,7 +157,7 @@ namespace Sora {
 			long long start = std::chrono::time_point_cast<std::chrono::microseconds>(m_StartTimepoint).time_since_epoch().count();
 			long long end = std::chrono::time_point_cast<std::chrono::microseconds>(endTimepoint).time_since_epoch().count();
 
-			size_t threadID = std::hash<std::thread::id>{}(std::this_thread::get_id());
+			size_t threadID = Instrumentor::GetThreadID();
 			Instrumentor::Get().WriteProfile({ m_Name, start, end, threadID });
 
 			m_Stopped = true;
@@ -127,9 +174,11 @@ namespace Sora {
 	#define SORA_PROFILE_END_SESSION() ::Sora::Instrumentor::Get().EndSession()
 	#define SORA_PROFILE_SCOPE(name) ::Sora::InstrumentationTimer timer##__LINE__(name);
 	#define SORA_PROFILE_FUNCTION() SORA_PROFILE_SCOPE(__FUNCSIG__)
+	#define SORA_PROFILE_THREAD(name) ::Sora::Instrumentor::Get().SetThreadName(name)
 #else
 	#define SORA_PROFILE_BEGIN_SESSION(name, filepath)
 	#define SORA_PROFILE_END_SESSION()
 	#define SORA_PROFILE_SCOPE(name)
 	#define SORA_PROFILE_FUNCTION() 
+	#define SORA_PROFILE_THREAD(name)
 #endif
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "sorapch.h"
+#include "Frustum.h"
+
+namespace Sora::Math {
+
+	Frustum::Frustum(const glm::mat4& viewProjection)
+	{
+		// Gribb/Hartmann: each plane is the last row of the matrix plus or minus one of the others.
+		glm::mat4 rows = glm::transpose(viewProjection);
+		m_Planes[0] = rows[3] + rows[0];	// Left
+		m_Planes[1] = rows[3] - rows[0];	// Right
+		m_Planes[2] = rows[3] + rows[1];	// Bottom
+		m_Planes[3] = rows[3] - rows[1];	// Top
+		m_Planes[4] = rows[3] + rows[2];	// Near
+		m_Planes[5] = rows[3] - rows[2];	// Far
+
+		for (glm::vec4& plane : m_Planes)
+		{
+			float length = glm::length(glm::vec3(plane));
+			if (length > 0.0f)
+				plane /= length;
+		}
+	}
+
+	bool Frustum::Intersects(const glm::vec3& center, const glm::vec3& extents) const
+	{
+		for (const glm::vec4& plane : m_Planes)
+		{
+			glm::vec3 normal(plane);
+			float radius = glm::dot(extents, glm::abs(normal));
+			if (glm::dot(normal, center) + plane.w < -radius)
+				return false;
+		}
+		return true;
+	}
+
+	void GetQuadBounds(const glm::mat4& transform, glm::vec3& o_Center, glm::vec3& o_Extents)
+	{
+		o_Center = glm::vec3(transform[3]);
+		o_Extents = (glm::abs(glm::vec3(transform[0])) + glm::abs(glm::vec3(transform[1]))) * 0.5f;
+	}
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Sora { namespace Math {
+
+	// The six clip planes of a view-projection matrix, in world space, facing inwards.
+	class Frustum
+	{
+	public:
+		Frustum() = default;
+		Frustum(const glm::mat4& viewProjection);
+
+		// Conservative: a box spanning a corner of the frustum may pass without being visible.
+		bool Intersects(const glm::vec3& center, const glm::vec3& extents) const;
+	private:
+		glm::vec4 m_Planes[6] = {};
+	};
+
+	// World-space bounding box of the unit quad (-0.5 .. 0.5 in X and Y) under transform, the shape 2D sprites and
+	// circles are drawn with.
+	void GetQuadBounds(const glm::mat4& transform, glm::vec3& o_Center, glm::vec3& o_Extents);
+
+} }
@@ -0,0 +1,338 @@
+#include "sorapch.h"
+#include "QuadTransform.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define SORA_SIMD_X86
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#endif
+#endif
+
+// MSVC accepts AVX2 intrinsics in any function, GCC and Clang only in functions compiled for that target.
+#if defined(SORA_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+	#define SORA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+	#define SORA_TARGET_AVX2
+#endif
+
+namespace Sora::Math {
+
+	// Corner offsets of the unit quad, matching Renderer2DData::QuadVertexPosition.
+	static constexpr float s_CornerX[4] = { -0.5f,  0.5f, 0.5f, -0.5f };
+	static constexpr float s_CornerY[4] = { -0.5f, -0.5f, 0.5f,  0.5f };
+
+	static void TransformQuadsScalar(const QuadTransformArrays& quads, size_t begin, size_t end, glm::vec3* corners)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			float c = std::cos(quads.Rotation[i]);
+			float s = std::sin(quads.Rotation[i]);
+			float sx = quads.ScaleX[i];
+			float sy = quads.ScaleY[i];
+
+			for (size_t j = 0; j < 4; j++)
+			{
+				float x = s_CornerX[j] * sx;
+				float y = s_CornerY[j] * sy;
+				corners[i * 4 + j] = { quads.TranslationX[i] + c * x - s * y, quads.TranslationY[i] + s * x + c * y, quads.TranslationZ[i] };
+			}
+		}
+	}
+
+	// Corner = translation +- half X axis +- half Y axis, in the order of s_CornerX and s_CornerY.
+	static void TransformQuadMatricesScalar(const glm::mat4* const* transforms, size_t begin, size_t end, glm::vec3* corners)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const glm::mat4& transform = *transforms[i];
+			glm::vec3 axisX = glm::vec3(transform[0]) * 0.5f;
+			glm::vec3 axisY = glm::vec3(transform[1]) * 0.5f;
+			glm::vec3 translation = glm::vec3(transform[3]);
+
+			corners[i * 4 + 0] = translation - axisX - axisY;
+			corners[i * 4 + 1] = translation + axisX - axisY;
+			corners[i * 4 + 2] = translation + axisX + axisY;
+			corners[i * 4 + 3] = translation - axisX + axisY;
+		}
+	}
+
+#ifdef SORA_SIMD_X86
+
+	// Sine and cosine after Cephes' sinf/cosf: reduce to [0, pi/4] by octant, then pick one of two polynomials.
+	// Accurate to a few ulp for the angle range a transform sees.
+
+	static void SinCos4(__m128 x, __m128& outSin, __m128& outCos)
+	{
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		__m128 signSin = _mm_and_ps(x, signMask);
+		x = _mm_andnot_ps(signMask, x);
+
+		__m128i octant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+		octant = _mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+		__m128 y = _mm_cvtepi32_ps(octant);
+
+		__m128 swapSignSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(4)), 29));
+		__m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_setzero_si128()));
+		__m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(octant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+		signSin = _mm_xor_ps(signSin, swapSignSin);
+
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+		__m128 z = _mm_mul_ps(x, x);
+
+		__m128 cosPoly = _mm_set1_ps(2.443315711809948e-5f);
+		cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(-1.388731625493765e-3f));
+		cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(4.166664568298827e-2f));
+		cosPoly = _mm_mul_ps(_mm_mul_ps(cosPoly, z), z);
+		cosPoly = _mm_add_ps(_mm_sub_ps(cosPoly, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+		__m128 sinPoly = _mm_set1_ps(-1.9515295891e-4f);
+		sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(8.3321608736e-3f));
+		sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(-1.6666654611e-1f));
+		sinPoly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinPoly, z), x), x);
+
+		__m128 sinResult = _mm_or_ps(_mm_and_ps(polyMask, sinPoly), _mm_andnot_ps(polyMask, cosPoly));
+		__m128 cosResult = _mm_or_ps(_mm_and_ps(polyMask, cosPoly), _mm_andnot_ps(polyMask, sinPoly));
+
+		outSin = _mm_xor_ps(sinResult, signSin);
+		outCos = _mm_xor_ps(cosResult, signCos);
+	}
+
+	SORA_TARGET_AVX2 static void SinCos8(__m256 x, __m256& outSin, __m256& outCos)
+	{
+		const __m256 signMask = _mm256_set1_ps(-0.0f);
+		__m256 signSin = _mm256_and_ps(x, signMask);
+		x = _mm256_andnot_ps(signMask, x);
+
+		__m256i octant = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)));
+		octant = _mm256_and_si256(_mm256_add_epi32(octant, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+		__m256 y = _mm256_cvtepi32_ps(octant);
+
+		__m256 swapSignSin = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(octant, _mm256_set1_epi32(4)), 29));
+		__m256 polyMask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(octant, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+		__m256 signCos = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(octant, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+		signSin = _mm256_xor_ps(signSin, swapSignSin);
+
+		x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(-0.78515625f)));
+		x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(-2.4187564849853515625e-4f)));
+		x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(-3.77489497744594108e-8f)));
+		__m256 z = _mm256_mul_ps(x, x);
+
+		__m256 cosPoly = _mm256_set1_ps(2.443315711809948e-5f);
+		cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, z), _mm256_set1_ps(-1.388731625493765e-3f));
+		cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, z), _mm256_set1_ps(4.166664568298827e-2f));
+		cosPoly = _mm256_mul_ps(_mm256_mul_ps(cosPoly, z), z);
+		cosPoly = _mm256_add_ps(_mm256_sub_ps(cosPoly, _mm256_mul_ps(z, _mm256_set1_ps(0.5f))), _mm256_set1_ps(1.0f));
+
+		__m256 sinPoly = _mm256_set1_ps(-1.9515295891e-4f);
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, z), _mm256_set1_ps(8.3321608736e-3f));
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, z), _mm256_set1_ps(-1.6666654611e-1f));
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sinPoly, z), x), x);
+
+		__m256 sinResult = _mm256_blendv_ps(cosPoly, sinPoly, polyMask);
+		__m256 cosResult = _mm256_blendv_ps(sinPoly, cosPoly, polyMask);
+
+		outSin = _mm256_xor_ps(sinResult, signSin);
+		outCos = _mm256_xor_ps(cosResult, signCos);
+	}
+
+	// The vector paths compute x and y for 8 quads in registers and interleave them into vec3 corners from a small
+	// aligned staging block.
+	static void InterleaveCorners(const float cornerX[4][8], const float cornerY[4][8], const float* translationZ, glm::vec3* corners)
+	{
+		for (size_t k = 0; k < 8; k++)
+		{
+			for (size_t j = 0; j < 4; j++)
+				corners[k * 4 + j] = { cornerX[j][k], cornerY[j][k], translationZ[k] };
+		}
+	}
+
+	static size_t TransformQuadsSSE2(const QuadTransformArrays& quads, size_t count, glm::vec3* corners)
+	{
+		alignas(16) float cornerX[4][8];
+		alignas(16) float cornerY[4][8];
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			for (size_t half = 0; half < 8; half += 4)
+			{
+				const size_t index = i + half;
+				__m128 tx = _mm_loadu_ps(quads.TranslationX + index);
+				__m128 ty = _mm_loadu_ps(quads.TranslationY + index);
+				__m128 halfScaleX = _mm_mul_ps(_mm_loadu_ps(quads.ScaleX + index), _mm_set1_ps(0.5f));
+				__m128 halfScaleY = _mm_mul_ps(_mm_loadu_ps(quads.ScaleY + index), _mm_set1_ps(0.5f));
+
+				__m128 s, c;
+				SinCos4(_mm_loadu_ps(quads.Rotation + index), s, c);
+
+				// Rotated half axes: corner = t +- axisX +- axisY.
+				__m128 axisXx = _mm_mul_ps(halfScaleX, c);
+				__m128 axisXy = _mm_mul_ps(halfScaleX, s);
+				__m128 axisYx = _mm_mul_ps(halfScaleY, s);
+				__m128 axisYy = _mm_mul_ps(halfScaleY, c);
+
+				_mm_store_ps(&cornerX[0][half], _mm_add_ps(_mm_sub_ps(tx, axisXx), axisYx));
+				_mm_store_ps(&cornerY[0][half], _mm_sub_ps(_mm_sub_ps(ty, axisXy), axisYy));
+				_mm_store_ps(&cornerX[1][half], _mm_add_ps(_mm_add_ps(tx, axisXx), axisYx));
+				_mm_store_ps(&cornerY[1][half], _mm_sub_ps(_mm_add_ps(ty, axisXy), axisYy));
+				_mm_store_ps(&cornerX[2][half], _mm_sub_ps(_mm_add_ps(tx, axisXx), axisYx));
+				_mm_store_ps(&cornerY[2][half], _mm_add_ps(_mm_add_ps(ty, axisXy), axisYy));
+				_mm_store_ps(&cornerX[3][half], _mm_sub_ps(_mm_sub_ps(tx, axisXx), axisYx));
+				_mm_store_ps(&cornerY[3][half], _mm_add_ps(_mm_sub_ps(ty, axisXy), axisYy));
+			}
+
+			InterleaveCorners(cornerX, cornerY, quads.TranslationZ + i, corners + i * 4);
+		}
+
+		return i;
+	}
+
+	static size_t TransformQuadMatricesSSE2(const glm::mat4* const* transforms, size_t count, glm::vec3* corners)
+	{
+		alignas(16) float staged[4][4];
+		const __m128 half = _mm_set1_ps(0.5f);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const float* transform = &(*transforms[i])[0][0];
+			__m128 axisX = _mm_mul_ps(_mm_loadu_ps(transform), half);
+			__m128 axisY = _mm_mul_ps(_mm_loadu_ps(transform + 4), half);
+			__m128 translation = _mm_loadu_ps(transform + 12);
+
+			_mm_store_ps(staged[0], _mm_sub_ps(_mm_sub_ps(translation, axisX), axisY));
+			_mm_store_ps(staged[1], _mm_sub_ps(_mm_add_ps(translation, axisX), axisY));
+			_mm_store_ps(staged[2], _mm_add_ps(_mm_add_ps(translation, axisX), axisY));
+			_mm_store_ps(staged[3], _mm_add_ps(_mm_sub_ps(translation, axisX), axisY));
+
+			// A 16 byte store per vec3 would run past the last corner.
+			for (size_t j = 0; j < 4; j++)
+				corners[i * 4 + j] = { staged[j][0], staged[j][1], staged[j][2] };
+		}
+
+		return count;
+	}
+
+	SORA_TARGET_AVX2 static size_t TransformQuadsAVX2(const QuadTransformArrays& quads, size_t count, glm::vec3* corners)
+	{
+		alignas(32) float cornerX[4][8];
+		alignas(32) float cornerY[4][8];
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 tx = _mm256_loadu_ps(quads.TranslationX + i);
+			__m256 ty = _mm256_loadu_ps(quads.TranslationY + i);
+			__m256 halfScaleX = _mm256_mul_ps(_mm256_loadu_ps(quads.ScaleX + i), _mm256_set1_ps(0.5f));
+			__m256 halfScaleY = _mm256_mul_ps(_mm256_loadu_ps(quads.ScaleY + i), _mm256_set1_ps(0.5f));
+
+			__m256 s, c;
+			SinCos8(_mm256_loadu_ps(quads.Rotation + i), s, c);
+
+			__m256 axisXx = _mm256_mul_ps(halfScaleX, c);
+			__m256 axisXy = _mm256_mul_ps(halfScaleX, s);
+			__m256 axisYx = _mm256_mul_ps(halfScaleY, s);
+			__m256 axisYy = _mm256_mul_ps(halfScaleY, c);
+
+			_mm256_store_ps(cornerX[0], _mm256_add_ps(_mm256_sub_ps(tx, axisXx), axisYx));
+			_mm256_store_ps(cornerY[0], _mm256_sub_ps(_mm256_sub_ps(ty, axisXy), axisYy));
+			_mm256_store_ps(cornerX[1], _mm256_add_ps(_mm256_add_ps(tx, axisXx), axisYx));
+			_mm256_store_ps(cornerY[1], _mm256_sub_ps(_mm256_add_ps(ty, axisXy), axisYy));
+			_mm256_store_ps(cornerX[2], _mm256_sub_ps(_mm256_add_ps(tx, axisXx), axisYx));
+			_mm256_store_ps(cornerY[2], _mm256_add_ps(_mm256_add_ps(ty, axisXy), axisYy));
+			_mm256_store_ps(cornerX[3], _mm256_sub_ps(_mm256_sub_ps(tx, axisXx), axisYx));
+			_mm256_store_ps(cornerY[3], _mm256_add_ps(_mm256_sub_ps(ty, axisXy), axisYy));
+
+			// The interleave is compiled without VEX encoding; clear the upper halves to avoid the transition penalty.
+			_mm256_zeroupper();
+			InterleaveCorners(cornerX, cornerY, quads.TranslationZ + i, corners + i * 4);
+		}
+
+		return i;
+	}
+
+	static bool CpuSupportsAVX2()
+	{
+	#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		// The OS has to save the YMM registers too.
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	#else
+		return __builtin_cpu_supports("avx2");
+	#endif
+	}
+
+#endif
+
+	SimdLevel GetSupportedSimdLevel()
+	{
+	#ifdef SORA_SIMD_X86
+		static const SimdLevel s_Level = CpuSupportsAVX2() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+		return s_Level;
+	#else
+		return SimdLevel::Scalar;
+	#endif
+	}
+
+	const char* SimdLevelToString(SimdLevel level)
+	{
+		switch (level)
+		{
+			case SimdLevel::Auto:	return "Auto";
+			case SimdLevel::Scalar:	return "Scalar";
+			case SimdLevel::SSE2:	return "SSE2";
+			case SimdLevel::AVX2:	return "AVX2";
+		}
+
+		SORA_CORE_ASSERT(false, "Unknown SimdLevel!");
+		return "";
+	}
+
+	void TransformQuads(const QuadTransformArrays& quads, size_t count, glm::vec3* corners, SimdLevel level)
+	{
+		SimdLevel supported = GetSupportedSimdLevel();
+		if (level == SimdLevel::Auto || level > supported)
+			level = supported;
+
+		size_t done = 0;
+	#ifdef SORA_SIMD_X86
+		switch (level)
+		{
+			case SimdLevel::SSE2:	done = TransformQuadsSSE2(quads, count, corners); break;
+			case SimdLevel::AVX2:	done = TransformQuadsAVX2(quads, count, corners); break;
+			default: break;
+		}
+	#endif
+
+		TransformQuadsScalar(quads, done, count, corners);
+	}
+
+	void TransformQuads(const glm::mat4* const* transforms, size_t count, glm::vec3* corners, SimdLevel level)
+	{
+		SimdLevel supported = GetSupportedSimdLevel();
+		if (level == SimdLevel::Auto || level > supported)
+			level = supported;
+
+		size_t done = 0;
+	#ifdef SORA_SIMD_X86
+		if (level >= SimdLevel::SSE2)
+			done = TransformQuadMatricesSSE2(transforms, count, corners);
+	#endif
+
+		TransformQuadMatricesScalar(transforms, done, count, corners);
+	}
+
+}
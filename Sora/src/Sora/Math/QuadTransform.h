@@ -0,0 +1,35 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Sora { namespace Math {
+
+	// Structure of arrays for quads rotated only around Z, the way 2D sprites use TransformComponent.
+	struct QuadTransformArrays
+	{
+		const float* TranslationX;
+		const float* TranslationY;
+		const float* TranslationZ;
+		const float* Rotation;		// Around Z, in radians.
+		const float* ScaleX;
+		const float* ScaleY;
+	};
+
+	enum class SimdLevel
+	{
+		Auto = 0, Scalar, SSE2, AVX2
+	};
+
+	// Best level the running CPU supports.
+	SimdLevel GetSupportedSimdLevel();
+	const char* SimdLevelToString(SimdLevel level);
+
+	// Writes the corners of each unit quad, in Renderer2D's vertex order, to corners[4 * i] .. corners[4 * i + 3].
+	// The vector paths handle 8 quads per iteration and finish the remainder with the scalar path.
+	void TransformQuads(const QuadTransformArrays& quads, size_t count, glm::vec3* corners, SimdLevel level = SimdLevel::Auto);
+	// The same for quads given by affine matrices, rotated any way, as transform * corner would. The matrices are read
+	// through pointers so that callers need not copy them out of their own records. The vector paths work on one quad
+	// at a time, a whole matrix column per register; AVX2 takes the SSE2 path.
+	void TransformQuads(const glm::mat4* const* transforms, size_t count, glm::vec3* corners, SimdLevel level = SimdLevel::Auto);
+
+} }
@@ -0,0 +1,341 @@
+#include "sorapch.h"
+#include "BlockCompression.h"
+
+#include "Sora/Core/JobSystem.h"
+
+#include <cfloat>
+#include <climits>
+
+namespace Sora { namespace BlockCompression {
+
+	namespace Utils {
+
+		// The line through the block along which its texels vary most, over the first 'channels' channels, clipped to
+		// the texels' projections onto it.
+		static void FindEndpoints(const uint8_t* texels, uint32_t channels, float* o_Min, float* o_Max)
+		{
+			float mean[4] = {};
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				for (uint32_t c = 0; c < channels; c++)
+					mean[c] += texels[i * 4 + c];
+			}
+			for (uint32_t c = 0; c < channels; c++)
+				mean[c] /= 16.0f;
+
+			float covariance[4][4] = {};
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				float delta[4] = {};
+				for (uint32_t c = 0; c < channels; c++)
+					delta[c] = texels[i * 4 + c] - mean[c];
+
+				for (uint32_t a = 0; a < channels; a++)
+				{
+					for (uint32_t b = 0; b < channels; b++)
+						covariance[a][b] += delta[a] * delta[b];
+				}
+			}
+
+			// Power iteration, started from the channel that varies most so it cannot start orthogonal to the answer.
+			float axis[4] = {};
+			uint32_t widest = 0;
+			for (uint32_t c = 1; c < channels; c++)
+			{
+				if (covariance[c][c] > covariance[widest][widest])
+					widest = c;
+			}
+			axis[widest] = 1.0f;
+
+			for (uint32_t iteration = 0; iteration < 8; iteration++)
+			{
+				float next[4] = {};
+				float largest = 0.0f;
+				for (uint32_t a = 0; a < channels; a++)
+				{
+					for (uint32_t b = 0; b < channels; b++)
+						next[a] += covariance[a][b] * axis[b];
+					largest = std::max(largest, std::abs(next[a]));
+				}
+
+				// A flat block, every texel equal.
+				if (largest == 0.0f)
+					break;
+
+				for (uint32_t c = 0; c < channels; c++)
+					axis[c] = next[c] / largest;
+			}
+
+			float length = 0.0f;
+			for (uint32_t c = 0; c < channels; c++)
+				length += axis[c] * axis[c];
+			length = std::sqrt(length);
+			for (uint32_t c = 0; c < channels; c++)
+				axis[c] /= length;
+
+			float minProjection = 0.0f, maxProjection = 0.0f;
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				float projection = 0.0f;
+				for (uint32_t c = 0; c < channels; c++)
+					projection += (texels[i * 4 + c] - mean[c]) * axis[c];
+
+				minProjection = std::min(minProjection, projection);
+				maxProjection = std::max(maxProjection, projection);
+			}
+
+			for (uint32_t c = 0; c < channels; c++)
+			{
+				o_Min[c] = std::clamp(mean[c] + minProjection * axis[c], 0.0f, 255.0f);
+				o_Max[c] = std::clamp(mean[c] + maxProjection * axis[c], 0.0f, 255.0f);
+			}
+		}
+
+		static uint32_t Distance(const uint8_t* texel, const int* color, uint32_t channels)
+		{
+			uint32_t distance = 0;
+			for (uint32_t c = 0; c < channels; c++)
+			{
+				int delta = (int)texel[c] - color[c];
+				distance += delta * delta;
+			}
+			return distance;
+		}
+
+		static uint16_t PackRGB565(const float* color)
+		{
+			uint16_t r = (uint16_t)(color[0] * 31.0f / 255.0f + 0.5f);
+			uint16_t g = (uint16_t)(color[1] * 63.0f / 255.0f + 0.5f);
+			uint16_t b = (uint16_t)(color[2] * 31.0f / 255.0f + 0.5f);
+			return (r << 11) | (g << 5) | b;
+		}
+
+		static void UnpackRGB565(uint16_t packed, int* color)
+		{
+			int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+			color[0] = (r << 3) | (r >> 2);
+			color[1] = (g << 2) | (g >> 4);
+			color[2] = (b << 3) | (b >> 2);
+		}
+
+		// Appends bits from the least significant end, the order BC7 is laid out in.
+		struct BitWriter
+		{
+			uint8_t* Data;
+			uint32_t Position = 0;
+
+			void Write(uint32_t value, uint32_t bits)
+			{
+				for (uint32_t i = 0; i < bits; i++, Position++)
+				{
+					if ((value >> i) & 1)
+						Data[Position / 8] |= 1 << (Position % 8);
+				}
+			}
+		};
+
+	}
+
+	void CompressBC1Block(const uint8_t texels[16 * 4], uint8_t* block)
+	{
+		float min[3], max[3];
+		Utils::FindEndpoints(texels, 3, min, max);
+
+		// Always the four colour mode, which BC3 requires of its colour block anyway.
+		uint16_t color0 = Utils::PackRGB565(max);
+		uint16_t color1 = Utils::PackRGB565(min);
+		if (color0 < color1)
+			std::swap(color0, color1);
+
+		uint32_t indices = 0;
+		if (color0 != color1)
+		{
+			int palette[4][3];
+			Utils::UnpackRGB565(color0, palette[0]);
+			Utils::UnpackRGB565(color1, palette[1]);
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				uint32_t best = 0, bestDistance = UINT32_MAX;
+				for (uint32_t p = 0; p < 4; p++)
+				{
+					uint32_t distance = Utils::Distance(&texels[i * 4], palette[p], 3);
+					if (distance < bestDistance)
+					{
+						best = p;
+						bestDistance = distance;
+					}
+				}
+				indices |= best << (i * 2);
+			}
+		}
+
+		memcpy(block + 0, &color0, sizeof(uint16_t));
+		memcpy(block + 2, &color1, sizeof(uint16_t));
+		memcpy(block + 4, &indices, sizeof(uint32_t));
+	}
+
+	void CompressBC3Block(const uint8_t texels[16 * 4], uint8_t* block)
+	{
+		uint8_t alpha0 = 0, alpha1 = 255;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			alpha0 = std::max(alpha0, texels[i * 4 + 3]);
+			alpha1 = std::min(alpha1, texels[i * 4 + 3]);
+		}
+
+		// alpha0 > alpha1 selects eight interpolated values. Equal endpoints leave every index at 0, which is alpha0.
+		uint64_t indices = 0;
+		if (alpha0 != alpha1)
+		{
+			int palette[8] = { alpha0, alpha1 };
+			for (int p = 2; p < 8; p++)
+				palette[p] = ((8 - p) * alpha0 + (p - 1) * alpha1) / 7;
+
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				uint64_t best = 0;
+				int bestDistance = INT_MAX;
+				for (uint32_t p = 0; p < 8; p++)
+				{
+					int distance = std::abs((int)texels[i * 4 + 3] - palette[p]);
+					if (distance < bestDistance)
+					{
+						best = p;
+						bestDistance = distance;
+					}
+				}
+				indices |= best << (i * 3);
+			}
+		}
+
+		block[0] = alpha0;
+		block[1] = alpha1;
+		for (uint32_t i = 0; i < 6; i++)
+			block[2 + i] = (uint8_t)(indices >> (i * 8));
+
+		CompressBC1Block(texels, block + 8);
+	}
+
+	void CompressBC7Block(const uint8_t texels[16 * 4], uint8_t* block)
+	{
+		static const int Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		float endpoints[2][4];
+		Utils::FindEndpoints(texels, 4, endpoints[0], endpoints[1]);
+
+		// Each endpoint is 7 bits per channel plus a p-bit shared by its channels, whichever of the two fits better.
+		uint32_t quantized[2][4];
+		uint32_t pbits[2];
+		for (uint32_t e = 0; e < 2; e++)
+		{
+			float bestError = FLT_MAX;
+			for (uint32_t p = 0; p < 2; p++)
+			{
+				uint32_t candidate[4];
+				float error = 0.0f;
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					candidate[c] = (uint32_t)std::clamp((int)((endpoints[e][c] - p) / 2.0f + 0.5f), 0, 127);
+					float delta = (float)((candidate[c] << 1) | p) - endpoints[e][c];
+					error += delta * delta;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					pbits[e] = p;
+					memcpy(quantized[e], candidate, sizeof(candidate));
+				}
+			}
+		}
+
+		int palette[16][4];
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			int color0 = (int)((quantized[0][c] << 1) | pbits[0]);
+			int color1 = (int)((quantized[1][c] << 1) | pbits[1]);
+			for (uint32_t p = 0; p < 16; p++)
+				palette[p][c] = ((64 - Weights[p]) * color0 + Weights[p] * color1 + 32) >> 6;
+		}
+
+		uint32_t indices[16];
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			uint32_t bestDistance = UINT32_MAX;
+			for (uint32_t p = 0; p < 16; p++)
+			{
+				uint32_t distance = Utils::Distance(&texels[i * 4], palette[p], 4);
+				if (distance < bestDistance)
+				{
+					indices[i] = p;
+					bestDistance = distance;
+				}
+			}
+		}
+
+		// The first index is stored without its top bit, which swapping the endpoints makes zero.
+		if (indices[0] & 8)
+		{
+			std::swap(quantized[0], quantized[1]);
+			std::swap(pbits[0], pbits[1]);
+			for (uint32_t& index : indices)
+				index = 15 - index;
+		}
+
+		memset(block, 0, BC7BlockBytes);
+		Utils::BitWriter writer = { block };
+		writer.Write(1 << 6, 7);
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			writer.Write(quantized[0][c], 7);
+			writer.Write(quantized[1][c], 7);
+		}
+		writer.Write(pbits[0], 1);
+		writer.Write(pbits[1], 1);
+
+		writer.Write(indices[0], 3);
+		for (uint32_t i = 1; i < 16; i++)
+			writer.Write(indices[i], 4);
+	}
+
+	// Rows of blocks per job. A row of a 1024 wide image is 256 blocks.
+	static const size_t CompressionGrainSize = 8;
+
+	void CompressImage(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t blockBytes,
+		void (*compressBlock)(const uint8_t*, uint8_t*), uint8_t* output)
+	{
+		// Rows of blocks are independent, and their output is at a known offset.
+		const uint32_t blocksPerRow = (width + 3) / 4;
+		const uint32_t blockRows = (height + 3) / 4;
+		JobSystem::ParallelFor(blockRows, CompressionGrainSize, [&](size_t beginRow, size_t endRow)
+			{
+				uint8_t texels[16 * 4];
+				uint8_t* block = output + beginRow * blocksPerRow * blockBytes;
+				for (uint32_t blockY = (uint32_t)beginRow * 4; blockY < endRow * 4; blockY += 4)
+				{
+					for (uint32_t blockX = 0; blockX < width; blockX += 4)
+					{
+						for (uint32_t y = 0; y < 4; y++)
+						{
+							const uint32_t sourceY = std::min(blockY + y, height - 1);
+							for (uint32_t x = 0; x < 4; x++)
+							{
+								const uint32_t sourceX = std::min(blockX + x, width - 1);
+								memcpy(&texels[(y * 4 + x) * 4], &rgba[((size_t)sourceY * width + sourceX) * 4], 4);
+							}
+						}
+
+						compressBlock(texels, block);
+						block += blockBytes;
+					}
+				}
+			});
+	}
+
+} }
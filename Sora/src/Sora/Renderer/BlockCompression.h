@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Sora { namespace BlockCompression {
+
+	// Encoders for 4x4 blocks of RGBA8 texels, given row by row. Meant for textures compressed once on import, so they
+	// trade some quality for speed: endpoints come from the principal axis of the block, not from an exhaustive search.
+
+	constexpr uint32_t BC1BlockBytes = 8;
+	constexpr uint32_t BC3BlockBytes = 16;
+	constexpr uint32_t BC7BlockBytes = 16;
+
+	// Opaque colour only, alpha is ignored.
+	void CompressBC1Block(const uint8_t texels[16 * 4], uint8_t* block);
+	// BC1 colour with an interpolated 8-bit alpha block.
+	void CompressBC3Block(const uint8_t texels[16 * 4], uint8_t* block);
+	// Mode 6 only: one RGBA endpoint pair at 7 bits plus a p-bit per endpoint, and 4-bit indices.
+	void CompressBC7Block(const uint8_t texels[16 * 4], uint8_t* block);
+
+	// Compresses a whole RGBA8 image, rows tightly packed. Edge blocks repeat the last row and column. Rows of blocks
+	// are spread over the job system.
+	void CompressImage(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t blockBytes,
+		void (*compressBlock)(const uint8_t*, uint8_t*), uint8_t* output);
+
+} }
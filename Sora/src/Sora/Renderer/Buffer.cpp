@@ -6,12 +6,12 @@
 
 namespace Sora {
 
-	Sora::Ref<Sora::VertexBuffer> VertexBuffer::Create(uint32_t size)
+	Sora::Ref<Sora::VertexBuffer> VertexBuffer::Create(uint32_t size, BufferUsage usage /*= BufferUsage::Dynamic*/, uint32_t regionCount /*= 3*/)
 	{
 		switch (Renderer::GetAPI())
 		{
 			case RendererAPI::API::None:	SORA_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
-			case RendererAPI::API::OpenGL:	return CreateRef<OpenGLVertexBuffer>(size);
+			case RendererAPI::API::OpenGL:	return CreateRef<OpenGLVertexBuffer>(size, usage, regionCount);
 		}
 
 		SORA_CORE_ASSERT(false, "Unknown RendererAPI!");
@@ -8,6 +8,7 @@ namespace Sora {
 		Float, Float2, Float3, Float4, 
 		Mat3, Mat4, 
 		Int, Int2, Int3, Int4, 
+		UInt, UInt2,
 		Bool
 	};
 
@@ -26,6 +27,8 @@ namespace Sora {
 			case ShaderDataType::Int2:	return 4 * 2;
 			case ShaderDataType::Int3:	return 4 * 3;
 			case ShaderDataType::Int4:	return 4 * 4;
+			case ShaderDataType::UInt:	return 4;
+			case ShaderDataType::UInt2:	return 4 * 2;
 			case ShaderDataType::Bool:	return 1;
 		}
 
@@ -65,6 +68,8 @@ namespace Sora {
 				case ShaderDataType::Int2:	return 2;
 				case ShaderDataType::Int3:	return 3;
 				case ShaderDataType::Int4:	return 4;
+				case ShaderDataType::UInt:	return 1;
+				case ShaderDataType::UInt2:	return 2;
 				case ShaderDataType::Bool:	return 1;
 			}
 
@@ -109,6 +114,14 @@ namespace Sora {
 		uint32_t m_Stride = 0;
 	};
 
+	enum class BufferUsage
+	{
+		Static = 0,
+		Dynamic,
+		// Persistently mapped ring of regions. The CPU writes a region directly while the GPU reads the others.
+		Stream
+	};
+
 	class VertexBuffer
 	{
 	public:
@@ -122,7 +135,18 @@ namespace Sora {
 
 		virtual void SetData(const void* data, uint32_t size) = 0;
 
-		static Ref<VertexBuffer> Create(uint32_t size);
+		// Stream buffers only. MapRegion waits until the GPU is done with the current region and returns its memory,
+		// ReleaseRegion must follow the draw that reads it and moves on to the next region.
+		virtual void* MapRegion() = 0;
+		virtual void ReleaseRegion() = 0;
+		virtual uint32_t GetRegionOffset() const = 0;
+		// Moves on to the next region while the current one still waits for its draw, so that a single draw can read
+		// several regions. The next ReleaseRegion covers the held regions as well, at most GetRegionCount() - 1 of them.
+		virtual void HoldRegion() = 0;
+		virtual uint32_t GetRegionCount() const = 0;
+
+		// Stream buffers hold 'regionCount' regions of 'size' bytes each.
+		static Ref<VertexBuffer> Create(uint32_t size, BufferUsage usage = BufferUsage::Dynamic, uint32_t regionCount = 3);
 		static Ref<VertexBuffer> Create(float* vertices, uint32_t size);
 	};
 
@@ -2,6 +2,8 @@
 
 #include "Sora/Core/Core.h"
 
+#include <glm/glm.hpp>
+
 namespace Sora {
 
 	enum class FramebufferTextureFormat
@@ -47,18 +49,45 @@ namespace Sora {
 		bool SwapChainTarget = false;
 	};
 
+	// A region of a color attachment, copied back to the CPU without waiting for the GPU.
+	struct FramebufferReadback
+	{
+		uint64_t RequestID = 0;
+		uint32_t AttachmentIndex = 0;
+		int X = 0, Y = 0;
+		uint32_t Width = 0, Height = 0;
+		// Row by row, bottom row first. RGBA8 attachments hold one packed pixel per value.
+		std::vector<int> Pixels;
+	};
+
 	class Framebuffer
 	{
 	public:
 		virtual void Bind() = 0;
 		virtual void Unbind() = 0;
 
+		// Only reallocates the attachments when the framebuffer grows past them. A smaller framebuffer renders into the
+		// bottom left corner of its attachments, see GetAttachmentWidth() and GetAttachmentHeight().
 		virtual void Resize(uint32_t width, uint32_t height) = 0;
+		// Waits for the GPU to finish rendering, use RequestReadback() for anything read every frame.
 		virtual int ReadPixel(uint32_t attachment_index, int x, int y) = 0;
 
+		// Queues a copy of a region of a color attachment, clipped to the framebuffer, behind the rendering submitted so
+		// far. Returns its ID, or 0 when every readback is still in flight and the request was dropped.
+		virtual uint64_t RequestReadback(uint32_t attachment_index, int x, int y, uint32_t width = 1, uint32_t height = 1) = 0;
+		// The oldest finished readback, in request order, usually one or two frames after its request. Never waits.
+		virtual bool PollReadback(FramebufferReadback& o_Readback) = 0;
+
+		// Clear the part of the attachment the framebuffer uses. The bound framebuffer, and the clear colour, are left
+		// alone.
 		virtual void ClearAttachment(uint32_t attachment_index, int value) = 0;
+		virtual void ClearAttachment(uint32_t attachment_index, const glm::vec4& value) = 0;
+		virtual void ClearDepthAttachment(float value = 1.0f) = 0;
 
 		virtual uint32_t GetColorAttachmentRendererID(uint32_t index = 0) const = 0;
+		// The size of the attachment textures, at least that of the framebuffer.
+		virtual uint32_t GetAttachmentWidth() const = 0;
+		virtual uint32_t GetAttachmentHeight() const = 0;
 
 		virtual const FramebufferSpecification& GetSpecification() const = 0;
 
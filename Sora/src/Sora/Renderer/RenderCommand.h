@@ -34,21 +34,77 @@ namespace Sora {
 		 *
 		 * @param vertex_array A reference to the VertexArray containing vertex data and index buffer
 		 * @param count The number of indices to use for drawing. If not provided, it uses the entire index buffer
+		 * @param baseVertex A constant added to every index, used to draw from a region of a stream buffer
 		 */
-		inline static void DrawIndexed(const Ref<VertexArray>& vertexArray, std::optional<uint32_t> indexCount = std::nullopt)
+		inline static void DrawIndexed(const Ref<VertexArray>& vertexArray, std::optional<uint32_t> indexCount = std::nullopt, uint32_t baseVertex = 0)
 		{
-			s_RendererAPI->DrawIndexed(vertexArray, indexCount);
+			s_RendererAPI->DrawIndexed(vertexArray, indexCount, baseVertex);
 		}
 
-		inline static void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
+		/**
+		 * @brief Draws the same indexed geometry several times.
+		 *
+		 * Per-instance attributes come from the instance buffers of the vertex array
+		 *
+		 * @param vertexArray A reference to the VertexArray containing the shared geometry and the instance buffers
+		 * @param indexCount The number of indices drawn for each instance
+		 * @param instanceCount The number of instances to draw
+		 * @param baseInstance Index of the first instance record to read
+		 */
+		inline static void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance = 0)
+		{
+			s_RendererAPI->DrawIndexedInstanced(vertexArray, indexCount, instanceCount, baseInstance);
+		}
+
+		inline static void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex = 0)
+		{
+			s_RendererAPI->DrawLines(vertexArray, vertexCount, firstVertex);
+		}
+
+		/**
+		 * @brief Draws several ranges of indexed geometry with a single call.
+		 *
+		 * Each command is drawn as by DrawIndexedInstanced, with its own base vertex and base instance
+		 *
+		 * @param vertexArray A reference to the VertexArray all commands read from
+		 * @param commands The draws, in the order they are executed
+		 * @param drawCount The number of commands
+		 */
+		inline static void MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const DrawIndexedIndirectCommand* commands, uint32_t drawCount)
 		{
-			s_RendererAPI->DrawLines(vertexArray, vertexCount);
+			s_RendererAPI->MultiDrawIndexedIndirect(vertexArray, commands, drawCount);
+		}
+
+		/**
+		 * @brief Draws several ranges of line vertices with a single call.
+		 *
+		 * Each command is drawn as by DrawLines, from its own first vertex
+		 *
+		 * @param vertexArray A reference to the VertexArray all commands read from
+		 * @param commands The draws, in the order they are executed
+		 * @param drawCount The number of commands
+		 */
+		inline static void MultiDrawLinesIndirect(const Ref<VertexArray>& vertexArray, const DrawArraysIndirectCommand* commands, uint32_t drawCount)
+		{
+			s_RendererAPI->MultiDrawLinesIndirect(vertexArray, commands, drawCount);
 		}
 
 		inline static void SetLineWidth(float width)
 		{
 			s_RendererAPI->SetLineWidth(width);
 		}
+
+		/**
+		 * @brief Turns writing to the depth buffer on or off. Depth testing stays as it is.
+		 *
+		 * Clearing the depth buffer only works with writes on
+		 *
+		 * @param enabled Whether draws write their depth
+		 */
+		inline static void SetDepthWrite(bool enabled)
+		{
+			s_RendererAPI->SetDepthWrite(enabled);
+		}
 	private:
 		static RendererAPI* s_RendererAPI;
 	};
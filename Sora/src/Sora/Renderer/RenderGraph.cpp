@@ -0,0 +1,349 @@
+#include "sorapch.h"
+#include "RenderGraph.h"
+
+namespace Sora {
+
+	struct RenderGraph::Target
+	{
+		std::string Name;
+		Ref<Framebuffer> Framebuffer;
+		FramebufferSpecification Spec;	// Transient targets only.
+		bool Transient = false;
+
+		// The first and last pass that uses a transient target, among the passes that are not culled.
+		uint32_t FirstPass = UINT32_MAX, LastPass = 0;
+	};
+
+	struct RenderGraph::Pass
+	{
+		struct Access
+		{
+			uint32_t Target;
+			uint32_t Attachment;
+			AttachmentLoadOp Load = AttachmentLoadOp::Load;
+
+			glm::vec4 ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
+			int ClearInteger = 0;
+			bool IntegerClear = false;
+			float ClearDepth = 1.0f;
+		};
+
+		std::string Name;
+		std::vector<Access> Reads;
+		std::vector<Access> Writes;
+		std::function<void()> Execute;
+		bool HasSideEffects = false;
+		bool Culled = false;
+	};
+
+	struct RenderGraph::TransientFramebuffer
+	{
+		Ref<Framebuffer> Framebuffer;
+		bool InUse = false;
+		bool UsedThisFrame = false;
+	};
+
+	namespace Utils {
+
+		static uint64_t AttachmentKey(uint32_t target, uint32_t attachment)
+		{
+			return ((uint64_t)target << 32) | attachment;
+		}
+
+		static bool HasSameAttachments(const FramebufferSpecification& a, const FramebufferSpecification& b)
+		{
+			if (a.Samples != b.Samples || a.Attachments.Attachments.size() != b.Attachments.Attachments.size())
+				return false;
+
+			for (size_t i = 0; i < a.Attachments.Attachments.size(); i++)
+			{
+				if (a.Attachments.Attachments[i].TextureFormat != b.Attachments.Attachments[i].TextureFormat)
+					return false;
+			}
+			return true;
+		}
+
+	}
+
+	void RenderGraph::PassBuilder::Read(RenderGraphTarget target, uint32_t attachment_index)
+	{
+		SORA_CORE_ASSERT(target.IsValid() && target.Index < m_Graph.m_Targets.size(), "Invalid render graph target!");
+
+		Pass::Access access;
+		access.Target = target.Index;
+		access.Attachment = attachment_index;
+		m_Graph.m_Passes[m_PassIndex].Reads.push_back(access);
+	}
+
+	void RenderGraph::PassBuilder::Write(RenderGraphTarget target, uint32_t attachment_index, AttachmentLoadOp load)
+	{
+		AddWrite(target, attachment_index, load);
+	}
+
+	void RenderGraph::PassBuilder::Clear(RenderGraphTarget target, uint32_t attachment_index, const glm::vec4& value)
+	{
+		AddWrite(target, attachment_index, AttachmentLoadOp::Clear);
+		m_Graph.m_Passes[m_PassIndex].Writes.back().ClearColor = value;
+	}
+
+	void RenderGraph::PassBuilder::Clear(RenderGraphTarget target, uint32_t attachment_index, int value)
+	{
+		AddWrite(target, attachment_index, AttachmentLoadOp::Clear);
+		m_Graph.m_Passes[m_PassIndex].Writes.back().ClearInteger = value;
+		m_Graph.m_Passes[m_PassIndex].Writes.back().IntegerClear = true;
+	}
+
+	void RenderGraph::PassBuilder::ClearDepth(RenderGraphTarget target, float value)
+	{
+		AddWrite(target, DepthAttachment, AttachmentLoadOp::Clear);
+		m_Graph.m_Passes[m_PassIndex].Writes.back().ClearDepth = value;
+	}
+
+	void RenderGraph::PassBuilder::SetSideEffects()
+	{
+		m_Graph.m_Passes[m_PassIndex].HasSideEffects = true;
+	}
+
+	void RenderGraph::PassBuilder::AddWrite(RenderGraphTarget target, uint32_t attachment_index, AttachmentLoadOp load)
+	{
+		SORA_CORE_ASSERT(target.IsValid() && target.Index < m_Graph.m_Targets.size(), "Invalid render graph target!");
+
+		Pass& pass = m_Graph.m_Passes[m_PassIndex];
+		SORA_CORE_ASSERT(pass.Writes.empty() || pass.Writes[0].Target == target.Index, "Pass '{0}' writes to more than one target!", pass.Name);
+
+		Pass::Access access;
+		access.Target = target.Index;
+		access.Attachment = attachment_index;
+		access.Load = load;
+		pass.Writes.push_back(access);
+	}
+
+	RenderGraph::RenderGraph() = default;
+	RenderGraph::~RenderGraph() = default;
+
+	void RenderGraph::Reset()
+	{
+		m_Targets.clear();
+		m_Passes.clear();
+		m_Outputs.clear();
+	}
+
+	RenderGraphTarget RenderGraph::ImportTarget(const std::string& name, const Ref<Framebuffer>& framebuffer)
+	{
+		Target& target = m_Targets.emplace_back();
+		target.Name = name;
+		target.Framebuffer = framebuffer;
+		return { (uint32_t)m_Targets.size() - 1 };
+	}
+
+	RenderGraphTarget RenderGraph::CreateTarget(const std::string& name, const FramebufferSpecification& spec)
+	{
+		Target& target = m_Targets.emplace_back();
+		target.Name = name;
+		target.Spec = spec;
+		target.Transient = true;
+		return { (uint32_t)m_Targets.size() - 1 };
+	}
+
+	void RenderGraph::SetOutput(RenderGraphTarget target, uint32_t attachment_index)
+	{
+		SORA_CORE_ASSERT(target.IsValid() && target.Index < m_Targets.size(), "Invalid render graph target!");
+		m_Outputs.emplace_back(target.Index, attachment_index);
+	}
+
+	void RenderGraph::AddPass(const std::string& name, const std::function<void(PassBuilder&)>& setup, const std::function<void()>& execute)
+	{
+		Pass& pass = m_Passes.emplace_back();
+		pass.Name = name;
+		pass.Execute = execute;
+
+		PassBuilder builder(*this, (uint32_t)m_Passes.size() - 1);
+		setup(builder);
+	}
+
+	const Ref<Framebuffer>& RenderGraph::GetFramebuffer(RenderGraphTarget target) const
+	{
+		SORA_CORE_ASSERT(target.IsValid() && target.Index < m_Targets.size(), "Invalid render graph target!");
+		return m_Targets[target.Index].Framebuffer;
+	}
+
+	void RenderGraph::Cull()
+	{
+		// Walks back from the outputs. Attachments a kept pass clears are not needed before it, the ones it loads or
+		// reads are.
+		std::unordered_set<uint64_t> needed;
+		for (const auto& [target, attachment] : m_Outputs)
+			needed.insert(Utils::AttachmentKey(target, attachment));
+
+		for (auto it = m_Passes.rbegin(); it != m_Passes.rend(); ++it)
+		{
+			Pass& pass = *it;
+			pass.Culled = !pass.HasSideEffects && std::none_of(pass.Writes.begin(), pass.Writes.end(), [&](const Pass::Access& write)
+			{
+				return needed.contains(Utils::AttachmentKey(write.Target, write.Attachment));
+			});
+
+			if (pass.Culled)
+				continue;
+
+			for (const Pass::Access& write : pass.Writes)
+			{
+				if (write.Load != AttachmentLoadOp::Load)
+					needed.erase(Utils::AttachmentKey(write.Target, write.Attachment));
+			}
+			for (const Pass::Access& write : pass.Writes)
+			{
+				if (write.Load == AttachmentLoadOp::Load)
+					needed.insert(Utils::AttachmentKey(write.Target, write.Attachment));
+			}
+			for (const Pass::Access& read : pass.Reads)
+				needed.insert(Utils::AttachmentKey(read.Target, read.Attachment));
+		}
+	}
+
+	void RenderGraph::AllocateTransientTargets()
+	{
+		for (uint32_t i = 0; i < m_Passes.size(); i++)
+		{
+			if (m_Passes[i].Culled)
+				continue;
+
+			auto use = [&](const Pass::Access& access)
+			{
+				Target& target = m_Targets[access.Target];
+				target.FirstPass = std::min(target.FirstPass, i);
+				target.LastPass = std::max(target.LastPass, i);
+			};
+			std::for_each(m_Passes[i].Reads.begin(), m_Passes[i].Reads.end(), use);
+			std::for_each(m_Passes[i].Writes.begin(), m_Passes[i].Writes.end(), use);
+		}
+
+		for (TransientFramebuffer& framebuffer : m_TransientFramebuffers)
+		{
+			framebuffer.InUse = false;
+			framebuffer.UsedThisFrame = false;
+		}
+
+		// Targets whose passes do not overlap take turns on the same framebuffer. Its attachments come from the render
+		// target pool, and only grow when a target is larger than every one before it.
+		std::vector<size_t> assigned(m_Targets.size(), SIZE_MAX);
+		for (uint32_t i = 0; i < m_Passes.size(); i++)
+		{
+			for (uint32_t t = 0; t < m_Targets.size(); t++)
+			{
+				Target& target = m_Targets[t];
+				if (!target.Transient || target.FirstPass != i)
+					continue;
+
+				auto it = std::find_if(m_TransientFramebuffers.begin(), m_TransientFramebuffers.end(), [&](const TransientFramebuffer& framebuffer)
+				{
+					return !framebuffer.InUse && Utils::HasSameAttachments(framebuffer.Framebuffer->GetSpecification(), target.Spec);
+				});
+
+				if (it == m_TransientFramebuffers.end())
+				{
+					m_TransientFramebuffers.push_back({ Framebuffer::Create(target.Spec) });
+					it = m_TransientFramebuffers.end() - 1;
+				}
+
+				it->InUse = true;
+				it->UsedThisFrame = true;
+				target.Framebuffer = it->Framebuffer;
+				assigned[t] = it - m_TransientFramebuffers.begin();
+				m_Stats.TransientTargetCount++;
+			}
+
+			for (uint32_t t = 0; t < m_Targets.size(); t++)
+			{
+				if (assigned[t] != SIZE_MAX && m_Targets[t].LastPass == i)
+					m_TransientFramebuffers[assigned[t]].InUse = false;
+			}
+		}
+
+		// Framebuffers no target wants this frame give their attachments back to the pool.
+		m_TransientFramebuffers.erase(std::remove_if(m_TransientFramebuffers.begin(), m_TransientFramebuffers.end(),
+			[](const TransientFramebuffer& framebuffer) { return !framebuffer.UsedThisFrame; }), m_TransientFramebuffers.end());
+
+		m_Stats.TransientFramebufferCount = (uint32_t)m_TransientFramebuffers.size();
+	}
+
+	void RenderGraph::Execute()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		m_Stats = Statistics();
+		m_Stats.PassCount = (uint32_t)m_Passes.size();
+
+		Cull();
+		AllocateTransientTargets();
+
+		std::unordered_set<uint64_t> written;
+		Framebuffer* bound = nullptr;
+		for (Pass& pass : m_Passes)
+		{
+			if (pass.Culled)
+			{
+				m_Stats.CulledPassCount++;
+				continue;
+			}
+
+			if (!pass.Writes.empty())
+			{
+				const Target& target = m_Targets[pass.Writes[0].Target];
+				Framebuffer* framebuffer = target.Framebuffer.get();
+				SORA_CORE_ASSERT(framebuffer, "Render graph target '{0}' has no framebuffer!", target.Name);
+
+				// Sized here, not when allocated, since aliased targets may differ in size. Resizing within the
+				// attachments is free.
+				const FramebufferSpecification& spec = framebuffer->GetSpecification();
+				if (target.Transient && (spec.Width != target.Spec.Width || spec.Height != target.Spec.Height))
+				{
+					framebuffer->Resize(target.Spec.Width, target.Spec.Height);
+					bound = nullptr;
+				}
+
+				// Consecutive passes into the same target share the binding.
+				if (framebuffer != bound)
+				{
+					framebuffer->Bind();
+					bound = framebuffer;
+				}
+
+				for (const Pass::Access& write : pass.Writes)
+				{
+					if (write.Load == AttachmentLoadOp::Clear)
+					{
+						if (write.Attachment == DepthAttachment)
+							framebuffer->ClearDepthAttachment(write.ClearDepth);
+						else if (write.IntegerClear)
+							framebuffer->ClearAttachment(write.Attachment, write.ClearInteger);
+						else
+							framebuffer->ClearAttachment(write.Attachment, write.ClearColor);
+
+						m_Stats.ClearCount++;
+					}
+					else if (write.Load == AttachmentLoadOp::Load && m_Targets[write.Target].Transient &&
+						!written.contains(Utils::AttachmentKey(write.Target, write.Attachment)))
+					{
+						SORA_CORE_WARN("Pass '{0}' loads '{1}' before any pass has written to it!", pass.Name, m_Targets[write.Target].Name);
+					}
+
+					written.insert(Utils::AttachmentKey(write.Target, write.Attachment));
+				}
+			}
+
+			pass.Execute();
+		}
+
+		if (bound)
+			bound->Unbind();
+
+		// Transient framebuffers stay alive in m_TransientFramebuffers, the targets let go of them.
+		for (Target& target : m_Targets)
+		{
+			if (target.Transient)
+				target.Framebuffer = nullptr;
+		}
+	}
+
+}
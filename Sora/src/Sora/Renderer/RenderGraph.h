@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Sora/Renderer/Framebuffer.h"
+
+#include <functional>
+
+namespace Sora {
+
+	enum class AttachmentLoadOp
+	{
+		Load = 0,	// Keep what earlier passes rendered.
+		Clear,
+		DontCare	// The pass overwrites all of it.
+	};
+
+	struct RenderGraphTarget
+	{
+		uint32_t Index = UINT32_MAX;
+
+		bool IsValid() const { return Index != UINT32_MAX; }
+	};
+
+	// The passes of a frame, and the framebuffers they render into. Passes run in the order they were added, but only
+	// when something downstream uses what they write: an output of the graph, a pass with side effects, or a pass that
+	// loads or reads it. Attachments are cleared where a pass asks for it, right after binding, and a culled pass takes
+	// its clears with it, so passes appended later that load an attachment add neither clears nor binds. Transient
+	// targets are created by the graph, and share framebuffers with other transient targets of the same attachments
+	// whose passes do not overlap.
+	//
+	// Rebuilt every frame: Reset(), declare the targets and passes, Execute().
+	class RenderGraph
+	{
+	public:
+		static const uint32_t DepthAttachment = UINT32_MAX;
+
+		struct Statistics
+		{
+			uint32_t PassCount = 0;
+			uint32_t CulledPassCount = 0;
+			uint32_t ClearCount = 0;
+			uint32_t TransientTargetCount = 0;
+			uint32_t TransientFramebufferCount = 0;	// After aliasing.
+		};
+
+		class PassBuilder
+		{
+		public:
+			void Read(RenderGraphTarget target, uint32_t attachment_index);
+			void Write(RenderGraphTarget target, uint32_t attachment_index, AttachmentLoadOp load = AttachmentLoadOp::Load);
+
+			void Clear(RenderGraphTarget target, uint32_t attachment_index, const glm::vec4& value);
+			void Clear(RenderGraphTarget target, uint32_t attachment_index, int value);
+			void ClearDepth(RenderGraphTarget target, float value = 1.0f);
+
+			// Keeps the pass even when nothing reads what it writes, e.g. for readbacks or simulation.
+			void SetSideEffects();
+		private:
+			PassBuilder(RenderGraph& graph, uint32_t passIndex)
+				: m_Graph(graph), m_PassIndex(passIndex) {}
+
+			void AddWrite(RenderGraphTarget target, uint32_t attachment_index, AttachmentLoadOp load);
+		private:
+			RenderGraph& m_Graph;
+			uint32_t m_PassIndex;
+
+			friend class RenderGraph;
+		};
+
+		RenderGraph();
+		~RenderGraph();
+
+		// Drops the passes and targets, but keeps the transient framebuffers for the next frame.
+		void Reset();
+
+		RenderGraphTarget ImportTarget(const std::string& name, const Ref<Framebuffer>& framebuffer);
+		RenderGraphTarget CreateTarget(const std::string& name, const FramebufferSpecification& spec);
+		// Keeps the passes that write the attachment, e.g. the one the viewport shows.
+		void SetOutput(RenderGraphTarget target, uint32_t attachment_index);
+
+		void AddPass(const std::string& name, const std::function<void(PassBuilder&)>& setup, const std::function<void()>& execute);
+
+		// Only valid during Execute() for transient targets.
+		const Ref<Framebuffer>& GetFramebuffer(RenderGraphTarget target) const;
+
+		void Execute();
+
+		const Statistics& GetStats() const { return m_Stats; }
+	private:
+		void Cull();
+		void AllocateTransientTargets();
+	private:
+		struct Target;
+		struct Pass;
+		struct TransientFramebuffer;
+
+		std::vector<Target> m_Targets;
+		std::vector<Pass> m_Passes;
+		std::vector<std::pair<uint32_t, uint32_t>> m_Outputs;
+		std::vector<TransientFramebuffer> m_TransientFramebuffers;
+
+		Statistics m_Stats;
+	};
+
+}
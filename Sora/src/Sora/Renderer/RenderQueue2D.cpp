@@ -0,0 +1,126 @@
+#include "sorapch.h"
+#include "RenderQueue2D.h"
+
+namespace Sora {
+
+	namespace Utils {
+
+		// In double: a float cannot hold 2^bits - 1 for more than 24 bits, and rounds it up to 2^bits, which would
+		// spill into the fields above the depth.
+		static uint64_t QuantizeDepth(float depth, uint32_t bits)
+		{
+			const uint64_t maxValue = (1ull << bits) - 1;
+			const double normalized = glm::clamp((double)depth * 0.5 + 0.5, 0.0, 1.0);
+			return std::min((uint64_t)(normalized * (double)maxValue), maxValue);
+		}
+
+		static uint64_t StateOf(RenderQueue2D::Pipeline pipeline, uint32_t textureID)
+		{
+			return ((uint64_t)pipeline << 32) | textureID;
+		}
+
+	}
+
+	void RenderQueue2D::Submit(const Command& command, int layer, bool translucent, Pipeline pipeline, uint32_t textureID, float depth)
+	{
+		uint64_t key = (uint64_t)(glm::clamp(layer, MinLayer, MaxLayer) - MinLayer) << 56;
+		if (translucent)
+		{
+			key |= 1ull << 55;
+			key |= ((1ull << 31) - 1 - Utils::QuantizeDepth(depth, 31)) << 24;
+			key |= (uint64_t)pipeline << 21;
+			key |= textureID & ((1u << 21) - 1);
+		}
+		else
+		{
+			key |= (uint64_t)pipeline << 52;
+			key |= (uint64_t)(textureID & ((1u << 24) - 1)) << 28;
+			key |= Utils::QuantizeDepth(depth, 28);
+		}
+
+		uint64_t state = Utils::StateOf(pipeline, textureID);
+		if (!m_States.empty() && m_States.back() != state)
+			m_SubmittedStateChanges++;
+
+		m_Commands.push_back(command);
+		m_Keys.push_back(key);
+		m_States.push_back(state);
+	}
+
+	const std::vector<uint32_t>& RenderQueue2D::Sort()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		const size_t count = m_Keys.size();
+
+		m_Order.resize(count);
+		m_OrderScratch.resize(count);
+		m_SortedKeys = m_Keys;
+		m_KeyScratch.resize(count);
+		for (uint32_t i = 0; i < (uint32_t)count; i++)
+			m_Order[i] = i;
+
+		// LSD radix sort on bytes. All histograms are built in one pass, and bytes every key agrees on are skipped.
+		uint32_t histograms[8][256] = {};
+		for (uint64_t key : m_SortedKeys)
+		{
+			for (uint32_t pass = 0; pass < 8; pass++)
+				histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+		}
+
+		for (uint32_t pass = 0; pass < 8; pass++)
+		{
+			uint32_t* histogram = histograms[pass];
+			const uint32_t shift = pass * 8;
+			if (histogram[(m_SortedKeys.empty() ? 0 : (m_SortedKeys[0] >> shift) & 0xFF)] == count)
+				continue;
+
+			uint32_t offset = 0;
+			for (uint32_t bucket = 0; bucket < 256; bucket++)
+			{
+				uint32_t bucketCount = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				uint32_t destination = histogram[(m_SortedKeys[i] >> shift) & 0xFF]++;
+				m_KeyScratch[destination] = m_SortedKeys[i];
+				m_OrderScratch[destination] = m_Order[i];
+			}
+
+			std::swap(m_SortedKeys, m_KeyScratch);
+			std::swap(m_Order, m_OrderScratch);
+		}
+
+		m_SortedStateChanges = 0;
+		for (size_t i = 1; i < count; i++)
+		{
+			if (m_States[m_Order[i]] != m_States[m_Order[i - 1]])
+				m_SortedStateChanges++;
+		}
+
+		return m_Order;
+	}
+
+	void RenderQueue2D::Clear()
+	{
+		m_Commands.clear();
+		m_Keys.clear();
+		m_States.clear();
+		m_Order.clear();
+
+		m_SubmittedStateChanges = 0;
+		m_SortedStateChanges = 0;
+	}
+
+	RenderQueue2D::Pipeline RenderQueue2D::GetPipeline(uint64_t key)
+	{
+		if (IsTranslucent(key))
+			return (Pipeline)((key >> 21) & 0x7);
+
+		return (Pipeline)((key >> 52) & 0x7);
+	}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Sora/Scene/Component.h"
+
+namespace Sora {
+
+	// Draw submissions of one scene, ordered by a 64-bit key before they reach the batcher.
+	//
+	// Key layout, most significant bits first:
+	//   [63..56] layer, [55] translucent, then
+	//   opaque:      [54..52] pipeline, [51..28] texture, [27..0] depth front to back
+	//   translucent: [54..24] depth back to front, [23..21] pipeline, [20..0] texture
+	class RenderQueue2D
+	{
+	public:
+		enum class Pipeline : uint8_t
+		{
+			QuadInstanced = 0, Quad, Circle
+		};
+
+		struct Command
+		{
+			glm::mat4 Transform;
+			SpriteRendererComponent* Sprite = nullptr;	// Exactly one of Sprite and Circle is set.
+			CircleRendererComponent* Circle = nullptr;
+			int EntityID = -1;
+		};
+
+		// Depth is the normalized device z of the command, -1 being nearest.
+		void Submit(const Command& command, int layer, bool translucent, Pipeline pipeline, uint32_t textureID, float depth);
+		// Returns the command indices in draw order.
+		const std::vector<uint32_t>& Sort();
+		void Clear();
+
+		bool IsEmpty() const { return m_Commands.empty(); }
+		const Command& GetCommand(uint32_t index) const { return m_Commands[index]; }
+		uint64_t GetKey(uint32_t index) const { return m_Keys[index]; }
+
+		// Pipeline or texture switches between neighbouring commands, in submission order and after Sort().
+		uint32_t GetSubmittedStateChanges() const { return m_SubmittedStateChanges; }
+		uint32_t GetSortedStateChanges() const { return m_SortedStateChanges; }
+
+		// Layers outside of [MinLayer, MaxLayer] are clamped to it.
+		static constexpr int MinLayer = -128;
+		static constexpr int MaxLayer = 127;
+
+		static int GetLayer(uint64_t key) { return (int)(key >> 56) + MinLayer; }
+		static bool IsTranslucent(uint64_t key) { return (key >> 55) & 1; }
+		static Pipeline GetPipeline(uint64_t key);
+	private:
+		std::vector<Command> m_Commands;
+		std::vector<uint64_t> m_Keys;
+		std::vector<uint64_t> m_States;
+
+		std::vector<uint32_t> m_Order;
+		std::vector<uint32_t> m_OrderScratch;
+		std::vector<uint64_t> m_KeyScratch;
+		std::vector<uint64_t> m_SortedKeys;
+
+		uint32_t m_SubmittedStateChanges = 0;
+		uint32_t m_SortedStateChanges = 0;
+	};
+
+}
@@ -0,0 +1,21 @@
+#include "sorapch.h"
+#include "RenderTargetPool.h"
+
+#include "Renderer.h"
+#include "Platform/OpenGL/OpenGLRenderTargetPool.h"
+
+namespace Sora {
+
+	Ref<RenderTargetPool> RenderTargetPool::Create()
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:	SORA_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+		case RendererAPI::API::OpenGL:	return CreateRef<OpenGLRenderTargetPool>();
+		}
+
+		SORA_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+}
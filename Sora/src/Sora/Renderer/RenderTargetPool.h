@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Sora/Renderer/Framebuffer.h"
+
+namespace Sora {
+
+	// Owns the textures framebuffers render into. Textures given back are kept for a while and handed to the next
+	// request for the same format and size, so that framebuffers which are recreated or resized back and forth do not
+	// allocate each time. Framebuffers round their sizes up to GetBucketSize() so that their requests match.
+	class RenderTargetPool
+	{
+	public:
+		static const uint32_t BucketGranularity = 256;
+
+		struct Statistics
+		{
+			uint32_t TextureCount = 0;
+			uint32_t InUseCount = 0;
+			uint64_t AllocatedBytes = 0;
+			uint64_t InUseBytes = 0;
+			uint32_t Allocations = 0;	// Since the pool was created.
+			uint32_t Reuses = 0;		// Since the pool was created.
+		};
+
+		virtual ~RenderTargetPool() = default;
+
+		virtual uint32_t Acquire(FramebufferTextureFormat format, uint32_t samples, uint32_t width, uint32_t height) = 0;
+		virtual void Release(uint32_t rendererID) = 0;
+
+		// Frees the textures that have not been acquired for a while. Called once per frame.
+		virtual void OnUpdate() = 0;
+
+		virtual Statistics GetStats() const = 0;
+
+		static uint32_t GetBucketSize(uint32_t size) { return (size + BucketGranularity - 1) / BucketGranularity * BucketGranularity; }
+
+		static Ref<RenderTargetPool> Create();
+	};
+
+}
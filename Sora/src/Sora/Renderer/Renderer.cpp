@@ -1,13 +1,13 @@
 #include "sorapch.h"
 #include "Renderer.h"
 
-#include "Platform/OpenGL/OpenGLShader.h"
-
 #include "Renderer2D.h"
 
 namespace Sora {
 
 	Renderer::SceneData* Renderer::m_SceneData = new Renderer::SceneData;
+	Scope<TextureStreamer> Renderer::s_TextureStreamer;
+	Ref<RenderTargetPool> Renderer::s_RenderTargetPool;
 
 	void Renderer::Init()
 	{
@@ -15,10 +15,14 @@ namespace Sora {
 
 		RenderCommand::Init();
 		Renderer2D::Init();
+		s_TextureStreamer = TextureStreamer::Create();
+		s_RenderTargetPool = RenderTargetPool::Create();
 	}
 
 	void Renderer::Shutdown()
 	{
+		s_TextureStreamer.reset();
+		s_RenderTargetPool.reset();
 		Renderer2D::Shutdown();
 	}
 
@@ -38,12 +42,37 @@ namespace Sora {
 
 	void Renderer::Submit(const Ref<Shader>& shader, const Ref<VertexArray>& vertexArray, const glm::mat4& transform)
 	{
+		const SubmitUniforms& uniforms = GetSubmitUniforms(shader);
 		shader->Bind();
-		std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformMat4("u_ViewProjection", m_SceneData->ViewProejctionMatrix);
-		std::dynamic_pointer_cast<OpenGLShader>(shader)->UploadUniformMat4("u_Transform", transform);
+		shader->Set(uniforms.ViewProjection, m_SceneData->ViewProejctionMatrix);
+		shader->Set(uniforms.Transform, transform);
 
 		vertexArray->Bind();
 		RenderCommand::DrawIndexed(vertexArray);
 	}
 
+	const Renderer::SubmitUniforms& Renderer::GetSubmitUniforms(const Ref<Shader>& shader)
+	{
+		// An entry whose owner is gone belongs to a destroyed shader that happened to live at the same address.
+		SubmitUniforms& uniforms = m_SceneData->Uniforms[shader.get()];
+		if (uniforms.Owner.lock() != shader || uniforms.RendererID != shader->GetRendererID())
+		{
+			uniforms.Owner = shader;
+			uniforms.RendererID = shader->GetRendererID();
+			uniforms.ViewProjection = shader->GetUniform<glm::mat4>("u_ViewProjection");
+			uniforms.Transform = shader->GetUniform<glm::mat4>("u_Transform");
+		}
+		return uniforms;
+	}
+
+	TextureStreamer& Renderer::GetTextureStreamer()
+	{
+		return *s_TextureStreamer;
+	}
+
+	const Ref<RenderTargetPool>& Renderer::GetRenderTargetPool()
+	{
+		return s_RenderTargetPool;
+	}
+
 } 
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #include "OrthographicCamera.h"
 #include "Shader.h"
+#include "TextureStreamer.h"
+#include "RenderTargetPool.h"
 
 namespace Sora {
 
@@ -19,14 +21,32 @@ namespace Sora {
 
 		static void Submit(const Ref<Shader>& shader, const Ref<VertexArray>& vertexArray, const glm::mat4& transform = glm::mat4(1.0f));
 
+		static TextureStreamer& GetTextureStreamer();
+		// Shared with the framebuffers that allocate from it, which may outlive the renderer.
+		static const Ref<RenderTargetPool>& GetRenderTargetPool();
+
 		inline static RendererAPI::API GetAPI() { return RendererAPI::GetAPI(); }
 	private:
+		// Resolved the first time a shader is submitted, and again after a hot reload replaced its program.
+		struct SubmitUniforms
+		{
+			std::weak_ptr<Shader> Owner;
+			uint32_t RendererID = 0;
+			ShaderUniform<glm::mat4> ViewProjection;
+			ShaderUniform<glm::mat4> Transform;
+		};
+
 		struct SceneData
 		{
 			glm::mat4 ViewProejctionMatrix;
+			std::unordered_map<const Shader*, SubmitUniforms> Uniforms;
 		};
 
+		static const SubmitUniforms& GetSubmitUniforms(const Ref<Shader>& shader);
+
 		static SceneData* m_SceneData;
+		static Scope<TextureStreamer> s_TextureStreamer;
+		static Ref<RenderTargetPool> s_RenderTargetPool;
 	};
 	
 }
@@ -5,9 +5,17 @@
 #include "Shader.h"
 #include "UniformBuffer.h"
 #include "RenderCommand.h"
+#include "TextureAtlas.h"
+#include "RenderQueue2D.h"
+
+#include "Sora/Math/Frustum.h"
+#include "Sora/Math/QuadTransform.h"
+#include "Sora/Core/JobSystem.h"
 
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/packing.hpp>
+
 
 namespace Sora {
 
@@ -21,6 +29,18 @@ namespace Sora {
 		int EntityID;
 	};
 
+	struct QuadInstance
+	{
+		glm::vec4 Basis;		// xy of the X axis, xy of the Y axis
+		glm::vec3 Translation;
+		uint32_t Color;			// RGBA8
+		uint32_t TexCoordMin;	// 2 x UNORM16
+		uint32_t TexCoordMax;	// 2 x UNORM16
+		int TexIndex;
+		float TilingFactor;
+		int EntityID;
+	};
+
 	struct CircleVertex
 	{
 		glm::vec3 WorldPosition;
@@ -38,21 +58,132 @@ namespace Sora {
 		int EntityID;
 	};
 
+	// A quad whose place in the mapped batch region is reserved, with its vertices still to be generated.
+	struct PendingQuad
+	{
+		const glm::mat4* Transform;
+		glm::vec4 Color;
+		glm::vec2 TexCoordMin;
+		glm::vec2 TexCoordMax;
+		float TexIndex;
+		float TilingFactor;
+		int EntityID;
+		uint32_t Destination;	// Instance index, or first vertex, inside the current region.
+		bool Instanced;
+	};
+
+	struct PendingCircle
+	{
+		const glm::mat4* Transform;
+		const CircleRendererComponent* Circle;
+		int EntityID;
+		uint32_t Destination;
+	};
+
+	// Per-texture bookkeeping, indexed by renderer ID so that finding a texture's slot never has to search.
+	struct TextureLookupEntry
+	{
+		const Texture2D* Owner = nullptr;
+		uint32_t BatchGeneration = 0;	// Slot is only meaningful inside the batch it was assigned in.
+		uint32_t Slot = 0;
+		bool ArrayResolved = false;
+		int32_t Page = -1;				// Texture array page holding a copy of the texture, -1 if none.
+		uint32_t Layer = 0;
+
+		const SubTexture2D* AtlasRegion = nullptr;	// Owned by the atlas, valid while AtlasGeneration matches.
+		uint32_t AtlasGeneration = 0;
+	};
+
+	// Equally sized textures share one GL_TEXTURE_2D_ARRAY, so they only take up a single sampler slot. Textures are
+	// moved into their layer rather than copied, so a page costs no memory on top of them.
+	struct TextureArrayPage
+	{
+		struct Layer
+		{
+			std::weak_ptr<Texture2D> Texture;
+			uint32_t RendererID = 0;
+		};
+
+		Ref<Texture2DArray> Array;
+		std::vector<Layer> Layers;
+		std::vector<uint32_t> FreeLayers;
+
+		uint32_t BatchGeneration = 0;
+		uint32_t Slot = 0;
+	};
+
+	// A static sprite together with the inputs its baked vertices were built from.
+	struct StaticSprite
+	{
+		glm::mat4 Transform;
+		glm::vec4 Color;
+		Ref<Texture2D> Texture;
+		float TilingFactor = 1.0f;
+		int Layer = 0;
+		glm::ivec2 Cell = glm::ivec2(0);
+		uint32_t Batch = 0;
+		uint32_t LastScene = 0;		// Last scene the sprite was submitted in.
+	};
+
+	// Static sprites whose vertices stay in a GPU buffer of their own, drawn without any per-frame vertex work until one
+	// of them changes.
+	struct StaticSpriteBatch
+	{
+		Ref<VertexArray> VertexArray;
+		Ref<VertexBuffer> VertexBuffer;
+		std::vector<int> Members;					// Entity IDs, in vertex order.
+		std::vector<Ref<Texture2D>> Textures;		// Bound from slot 1, slot 0 being the white texture.
+		int Layer = 0;								// Of every member. Empty batches take any sprite.
+		glm::ivec2 Cell = glm::ivec2(0);
+		glm::vec3 BoundsCenter = glm::vec3(0.0f);
+		glm::vec3 BoundsExtents = glm::vec3(0.0f);
+		bool Dirty = true;
+	};
+
 	struct Renderer2DData
 	{
 		static const uint32_t MaxQuads = 20000;
 		static const uint32_t MaxVertices = MaxQuads * 4;
 		static const uint32_t MaxIndices = MaxQuads * 6;
-		static const uint32_t MaxTextureSlots = 32;
+		static const uint32_t MaxTextureSlots = 24;
+		static const uint32_t MaxTextureArraySlots = 8;			// Bound right after the regular slots.
+		static const uint32_t TextureLayerShift = 8;				// TexIndex = slot | layer << TextureLayerShift
+		static const uint32_t MaxTextureArrayLayerSize = 512;		// Bigger textures keep a slot of their own.
+		static const uint32_t TextureArrayPageBytes = 16 * 1024 * 1024;
+		static const uint32_t MaxStaticBatchQuads = 4096;
+		// Regions of each stream buffer. A Flush() draws up to all of them but one with a single call per pipeline, so
+		// this is how many full batches a frame can merge.
+		static const uint32_t StreamRegionCount = 8;
+		static constexpr float StaticBatchCellSize = 32.0f;		// In world units. Sprites are placed by their origin.
 
 		Ref<VertexArray> QuadVertexArray;
 		Ref<VertexBuffer> QuadVertexBuffer;
+		Ref<IndexBuffer> QuadIndexBuffer;
 		Ref<Shader> QuadShader;
 
 		uint32_t QuadIndexCount = 0;
 		QuadVertex* QuadVertexBufferBase = nullptr;
 		QuadVertex* QuadVertexBufferPtr = nullptr;
 
+		Ref<VertexArray> QuadInstanceVertexArray;
+		Ref<VertexBuffer> QuadInstanceBuffer;
+		Ref<Shader> QuadInstanceShader;
+
+		uint32_t QuadInstanceCount = 0;
+		QuadInstance* QuadInstanceBufferBase = nullptr;
+		QuadInstance* QuadInstanceBufferPtr = nullptr;
+
+		bool QuadInstancing = true;
+
+		// Draws of the stream regions filled since the last Flush(). When a batch only runs out of room its regions are
+		// held rather than drawn, and Flush() submits all of them with one indirect call per pipeline.
+		std::vector<DrawIndexedIndirectCommand> QuadCommands;
+		std::vector<DrawIndexedIndirectCommand> QuadInstanceCommands;
+		std::vector<DrawIndexedIndirectCommand> CircleCommands;
+		std::vector<DrawArraysIndirectCommand> LineCommands;
+		uint32_t HeldRegionCount = 0;
+		bool MultiDrawIndirect = true;
+
 		Ref<VertexArray> CircleVertexArray;
 		Ref<VertexBuffer> CircleVertexBuffer;
 		Ref<Shader> CircleShader;
@@ -73,9 +204,34 @@ namespace Sora {
 
 		Ref<Texture2D> WhiteTexture;
 
+		ShaderLibrary Shaders;
+
 		std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
 		uint32_t TextureSlotIndex = 1;
 
+		std::array<Ref<Texture2DArray>, MaxTextureArraySlots> TextureArraySlots;
+		uint32_t TextureArraySlotIndex = 0;
+
+		uint32_t TextureBatchGeneration = 0;
+		std::vector<TextureLookupEntry> TextureLookup;
+		std::vector<TextureArrayPage> TextureArrayPages;
+
+		TextureAtlas SpriteAtlas;
+
+		RenderQueue2D Queue;
+
+		static const size_t VertexGenerationChunkSize = 1024;
+		static const size_t QuadTransformBlockSize = 64;			// Quads whose corners are computed at once, on the stack.
+		std::vector<PendingQuad> PendingQuads;
+		std::vector<PendingCircle> PendingCircles;
+
+		std::unordered_map<int, StaticSprite> StaticSprites;
+		std::vector<StaticSpriteBatch> StaticBatches;
+		uint32_t SceneIndex = 1;
+		uint32_t StaticSpritesSeen = 0;		// Distinct static sprites submitted in the current scene.
+		std::vector<int> StaticLayers;			// Layers with static batches to draw in the current scene, ascending.
+		bool SceneUsedQueue = false;
+
 		glm::vec4 QuadVertexPosition[4];
 
 		Renderer2D::Statistics Stats;
@@ -86,6 +242,9 @@ namespace Sora {
 		};
 		CameraData CameraBuffer;
 		Ref<UniformBuffer> CameraUniformBuffer;
+
+		// Built from CameraBuffer.ViewProjection at BeginScene(), queued submissions outside of it are dropped.
+		Math::Frustum ViewFrustum;
 	};
 
 	static Renderer2DData s_Data;
@@ -96,7 +255,7 @@ namespace Sora {
 
 		// Quad
 		s_Data.QuadVertexArray = VertexArray::Create();
-		s_Data.QuadVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(QuadVertex));
+		s_Data.QuadVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(QuadVertex), BufferUsage::Stream, Renderer2DData::StreamRegionCount);
 		s_Data.QuadVertexBuffer->SetLayout({
 			{ ShaderDataType::Float3,	"a_Position"	},
 			{ ShaderDataType::Float4,	"a_Color"		},
@@ -106,7 +265,6 @@ namespace Sora {
 			{ ShaderDataType::Int,		"a_EntityID"	}
 		});
 		s_Data.QuadVertexArray->AddVertexBuffer(s_Data.QuadVertexBuffer);
-		s_Data.QuadVertexBufferBase = new QuadVertex[s_Data.MaxVertices];
 
 		uint32_t* quadIndices = new uint32_t[Renderer2DData::MaxIndices];
 		uint32_t offset = 0;
@@ -124,11 +282,40 @@ namespace Sora {
 		}
 		Ref<IndexBuffer> quadIB = IndexBuffer::Create(quadIndices, Renderer2DData::MaxIndices);
 		s_Data.QuadVertexArray->SetIndexBuffer(quadIB);
+		s_Data.QuadIndexBuffer = quadIB;
 		delete[] quadIndices;
 
+		// Instanced quad
+		float unitQuadVertices[] = {
+			-0.5f, -0.5f,
+			 0.5f, -0.5f,
+			 0.5f,  0.5f,
+			-0.5f,  0.5f
+		};
+
+		s_Data.QuadInstanceVertexArray = VertexArray::Create();
+		Ref<VertexBuffer> unitQuadVB = VertexBuffer::Create(unitQuadVertices, sizeof(unitQuadVertices));
+		unitQuadVB->SetLayout({
+			{ ShaderDataType::Float2,	"a_LocalPosition"}
+			});
+		s_Data.QuadInstanceVertexArray->AddVertexBuffer(unitQuadVB);
+
+		s_Data.QuadInstanceBuffer = VertexBuffer::Create(s_Data.MaxQuads * sizeof(QuadInstance), BufferUsage::Stream, Renderer2DData::StreamRegionCount);
+		s_Data.QuadInstanceBuffer->SetLayout({
+			{ ShaderDataType::Float4,	"a_Basis"		},
+			{ ShaderDataType::Float3,	"a_Translation"	},
+			{ ShaderDataType::UInt,		"a_Color"		},
+			{ ShaderDataType::UInt2,	"a_TexRect"		},
+			{ ShaderDataType::Int,		"a_TexIndex"	},
+			{ ShaderDataType::Float,	"a_TilingFactor"},
+			{ ShaderDataType::Int,		"a_EntityID"	}
+			});
+		s_Data.QuadInstanceVertexArray->AddInstanceBuffer(s_Data.QuadInstanceBuffer);
+		s_Data.QuadInstanceVertexArray->SetIndexBuffer(quadIB); // The first 6 indices describe a single quad.
+
 		// Circle
 		s_Data.CircleVertexArray = VertexArray::Create();
-		s_Data.CircleVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(CircleVertex));
+		s_Data.CircleVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(CircleVertex), BufferUsage::Stream, Renderer2DData::StreamRegionCount);
 		s_Data.CircleVertexBuffer->SetLayout({
 			{ ShaderDataType::Float3,	"a_WorldPosition"},
 			{ ShaderDataType::Float3,	"a_LocalPosition"},
@@ -139,11 +326,10 @@ namespace Sora {
 			});
 		s_Data.CircleVertexArray->AddVertexBuffer(s_Data.CircleVertexBuffer);
 		s_Data.CircleVertexArray->SetIndexBuffer(quadIB);
-		s_Data.CircleVertexBufferBase = new CircleVertex[s_Data.MaxVertices];
 
 		// Line
 		s_Data.LineVertexArray = VertexArray::Create();
-		s_Data.LineVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(LineVertex));
+		s_Data.LineVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(LineVertex), BufferUsage::Stream, Renderer2DData::StreamRegionCount);
 		s_Data.LineVertexBuffer->SetLayout({
 			{ ShaderDataType::Float3,	"a_Position"},
 			{ ShaderDataType::Float4,	"a_Color"	},
@@ -151,7 +337,6 @@ namespace Sora {
 			});
 		s_Data.LineVertexArray->AddVertexBuffer(s_Data.LineVertexBuffer);
 		s_Data.LineVertexArray->SetIndexBuffer(quadIB);
-		s_Data.LineVertexBufferBase = new LineVertex[s_Data.MaxVertices];
 
 		s_Data.WhiteTexture = Texture2D::Create(1, 1);
 		uint32_t whiteTextureData = 0xffffffff;
@@ -161,9 +346,18 @@ namespace Sora {
 		for (uint32_t i = 0; i < Renderer2DData::MaxTextureSlots; i++)
 			sampler[i] = i;
 
-		s_Data.QuadShader = Shader::Create("assets/shaders/Renderer2D_Quad.glsl");
-		s_Data.CircleShader = Shader::Create("assets/shaders/Renderer2D_Circle.glsl");
-		s_Data.LineShader = Shader::Create("assets/shaders/Renderer2D_Line.glsl");
+		auto shaders = Shader::Create({
+			"assets/shaders/Renderer2D_Quad.glsl",
+			"assets/shaders/Renderer2D_QuadInstanced.glsl",
+			"assets/shaders/Renderer2D_Circle.glsl",
+			"assets/shaders/Renderer2D_Line.glsl"
+		});
+		s_Data.QuadShader = shaders[0];
+		s_Data.QuadInstanceShader = shaders[1];
+		s_Data.CircleShader = shaders[2];
+		s_Data.LineShader = shaders[3];
+		for (const auto& shader : shaders)
+			s_Data.Shaders.Add(shader);
 
 		// Set white texture at index 0.
 		s_Data.TextureSlots[0] = s_Data.WhiteTexture;
@@ -180,8 +374,8 @@ namespace Sora {
 	{
 		SORA_PROFILE_FUNCTION();
 
-		delete[] s_Data.QuadVertexBufferBase;
-		delete[] s_Data.CircleVertexBufferBase;
+		// The batch pointers point into the stream buffers, which are released together with s_Data.
+		s_Data = Renderer2DData();
 	}
 
 	void Renderer2D::BeginScene(const Camera& camera, const glm::mat4& transform)
@@ -189,6 +383,7 @@ namespace Sora {
 		SORA_PROFILE_FUNCTION();
 
 		s_Data.CameraBuffer.ViewProjection = camera.GetProjection() * glm::inverse(transform);
+		s_Data.ViewFrustum = Math::Frustum(s_Data.CameraBuffer.ViewProjection);
 		s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(Renderer2DData::CameraData));
 
 		StartBatch();
@@ -198,8 +393,9 @@ namespace Sora {
 	{
 		SORA_PROFILE_FUNCTION();
 
-		s_Data.QuadShader->Bind();
-		s_Data.QuadShader->SetMat4("u_ViewProjection", camera.GetViewProjectionMatrix());
+		s_Data.CameraBuffer.ViewProjection = camera.GetViewProjectionMatrix();
+		s_Data.ViewFrustum = Math::Frustum(s_Data.CameraBuffer.ViewProjection);
+		s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(Renderer2DData::CameraData));
 
 		StartBatch();
 	}
@@ -209,6 +405,7 @@ namespace Sora {
 		SORA_PROFILE_FUNCTION();
 
 		s_Data.CameraBuffer.ViewProjection = camera.GetViewProjection();
+		s_Data.ViewFrustum = Math::Frustum(s_Data.CameraBuffer.ViewProjection);
 		s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(Renderer2DData::CameraData));
 
 		StartBatch();
@@ -218,58 +415,253 @@ namespace Sora {
 	{
 		SORA_PROFILE_FUNCTION();
 
+		UpdateStaticBatches();
+		DrawQueue();
 		Flush();
 	}
 
-	void Renderer2D::Flush()
+	static void RecordRegionDraws()
 	{
+		// Vertices were written straight into the mapped stream regions, so there is nothing left to upload here.
 		if (s_Data.QuadIndexCount)
 		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.QuadVertexBufferPtr - (uint8_t*)s_Data.QuadVertexBufferBase);
-			s_Data.QuadVertexBuffer->SetData(s_Data.QuadVertexBufferBase, dataSize);
+			s_Data.Stats.UploadedBytes += (uint32_t)((uint8_t*)s_Data.QuadVertexBufferPtr - (uint8_t*)s_Data.QuadVertexBufferBase);
 
+			int32_t baseVertex = (int32_t)(s_Data.QuadVertexBuffer->GetRegionOffset() / sizeof(QuadVertex));
+			s_Data.QuadCommands.push_back({ s_Data.QuadIndexCount, 1, 0, baseVertex, 0 });
+		}
+
+		if (s_Data.QuadInstanceCount)
+		{
+			s_Data.Stats.UploadedBytes += (uint32_t)((uint8_t*)s_Data.QuadInstanceBufferPtr - (uint8_t*)s_Data.QuadInstanceBufferBase);
+
+			uint32_t baseInstance = s_Data.QuadInstanceBuffer->GetRegionOffset() / sizeof(QuadInstance);
+			s_Data.QuadInstanceCommands.push_back({ 6, s_Data.QuadInstanceCount, 0, 0, baseInstance });
+		}
+
+		if (s_Data.CircleIndexCount)
+		{
+			s_Data.Stats.UploadedBytes += (uint32_t)((uint8_t*)s_Data.CircleVertexBufferPtr - (uint8_t*)s_Data.CircleVertexBufferBase);
+
+			int32_t baseVertex = (int32_t)(s_Data.CircleVertexBuffer->GetRegionOffset() / sizeof(CircleVertex));
+			s_Data.CircleCommands.push_back({ s_Data.CircleIndexCount, 1, 0, baseVertex, 0 });
+		}
+
+		if (s_Data.LineVertexCount)
+		{
+			s_Data.Stats.UploadedBytes += (uint32_t)((uint8_t*)s_Data.LineVertexBufferPtr - (uint8_t*)s_Data.LineVertexBufferBase);
+
+			uint32_t firstVertex = s_Data.LineVertexBuffer->GetRegionOffset() / sizeof(LineVertex);
+			s_Data.LineCommands.push_back({ s_Data.LineVertexCount, 1, firstVertex, 0 });
+		}
+	}
+
+	static void SubmitRegionDraws(const Ref<VertexArray>& vertexArray, std::vector<DrawIndexedIndirectCommand>& commands)
+	{
+		if (commands.size() == 1)
+		{
+			const DrawIndexedIndirectCommand& command = commands[0];
+			if (command.InstanceCount != 1 || command.BaseInstance)
+				RenderCommand::DrawIndexedInstanced(vertexArray, command.IndexCount, command.InstanceCount, command.BaseInstance);
+			else
+				RenderCommand::DrawIndexed(vertexArray, command.IndexCount, command.BaseVertex);
+		}
+		else
+		{
+			RenderCommand::MultiDrawIndexedIndirect(vertexArray, commands.data(), (uint32_t)commands.size());
+			s_Data.Stats.IndirectDrawCount += (uint32_t)commands.size();
+		}
+
+		s_Data.Stats.DrawCallCount++;
+		commands.clear();
+	}
+
+	void Renderer2D::Flush()
+	{
+		GeneratePendingVertices();
+		RecordRegionDraws();
+
+		if (!s_Data.QuadCommands.empty() || !s_Data.QuadInstanceCommands.empty())
+		{
 			for (uint32_t i = 0; i < s_Data.TextureSlotIndex; i++)
 				s_Data.TextureSlots[i]->Bind(i);
 
+			for (uint32_t i = 0; i < s_Data.TextureArraySlotIndex; i++)
+				s_Data.TextureArraySlots[i]->Bind(Renderer2DData::MaxTextureSlots + i);
+		}
+
+		if (!s_Data.QuadCommands.empty())
+		{
 			s_Data.QuadShader->Bind();
-			RenderCommand::DrawIndexed(s_Data.QuadVertexArray, s_Data.QuadIndexCount);
-			s_Data.Stats.DrawCallCount++;
+			SubmitRegionDraws(s_Data.QuadVertexArray, s_Data.QuadCommands);
+			s_Data.QuadVertexBuffer->ReleaseRegion();
 		}
 
-		if (s_Data.CircleIndexCount)
+		if (!s_Data.QuadInstanceCommands.empty())
 		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.CircleVertexBufferPtr - (uint8_t*)s_Data.CircleVertexBufferBase);
-			s_Data.CircleVertexBuffer->SetData(s_Data.CircleVertexBufferBase, dataSize);
+			s_Data.QuadInstanceShader->Bind();
+			SubmitRegionDraws(s_Data.QuadInstanceVertexArray, s_Data.QuadInstanceCommands);
+			s_Data.QuadInstanceBuffer->ReleaseRegion();
+		}
 
+		if (!s_Data.CircleCommands.empty())
+		{
 			s_Data.CircleShader->Bind();
-			RenderCommand::DrawIndexed(s_Data.CircleVertexArray, s_Data.CircleIndexCount);
-			s_Data.Stats.DrawCallCount++;
+			SubmitRegionDraws(s_Data.CircleVertexArray, s_Data.CircleCommands);
+			s_Data.CircleVertexBuffer->ReleaseRegion();
 		}
 
-		if (s_Data.LineVertexCount)
+		if (!s_Data.LineCommands.empty())
 		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.LineVertexBufferPtr - (uint8_t*)s_Data.LineVertexBufferBase);
-			s_Data.LineVertexBuffer->SetData(s_Data.LineVertexBufferBase, dataSize);
-
 			s_Data.LineShader->Bind();
 			RenderCommand::SetLineWidth(s_Data.LineWidth);
-			RenderCommand::DrawLines(s_Data.LineVertexArray, s_Data.LineVertexCount);
+			if (s_Data.LineCommands.size() == 1)
+				RenderCommand::DrawLines(s_Data.LineVertexArray, s_Data.LineCommands[0].VertexCount, s_Data.LineCommands[0].FirstVertex);
+			else
+			{
+				RenderCommand::MultiDrawLinesIndirect(s_Data.LineVertexArray, s_Data.LineCommands.data(), (uint32_t)s_Data.LineCommands.size());
+				s_Data.Stats.IndirectDrawCount += (uint32_t)s_Data.LineCommands.size();
+			}
 			s_Data.Stats.DrawCallCount++;
+			s_Data.LineVertexBuffer->ReleaseRegion();
+			s_Data.LineCommands.clear();
+		}
+
+		s_Data.HeldRegionCount = 0;
+	}
+
+	static void ReleaseExpiredTextureLayers()
+	{
+		for (size_t pageIndex = 0; pageIndex < s_Data.TextureArrayPages.size(); pageIndex++)
+		{
+			TextureArrayPage& page = s_Data.TextureArrayPages[pageIndex];
+			for (uint32_t layer = 0; layer < (uint32_t)page.Layers.size(); layer++)
+			{
+				TextureArrayPage::Layer& slot = page.Layers[layer];
+				if (slot.RendererID == 0 || !slot.Texture.expired())
+					continue;
+
+				// The renderer ID may be handed out again, so forget what it used to map to.
+				TextureLookupEntry& entry = s_Data.TextureLookup[slot.RendererID];
+				if (entry.Page == (int32_t)pageIndex && entry.Layer == layer)
+					entry = TextureLookupEntry();
+
+				slot = TextureArrayPage::Layer();
+				page.FreeLayers.push_back(layer);
+			}
+
+			// Pages keep their index, entries refer to them by it, but an empty one gives its memory back.
+			if (page.Array && page.FreeLayers.size() == page.Layers.size())
+				page = TextureArrayPage();
 		}
 	}
 
-	void Renderer2D::StartBatch()
+	static TextureLookupEntry& LookupTexture(const Ref<Texture2D>& texture);
+
+	// Returns the entry of the texture, which moves along with its renderer ID when the texture is packed.
+	static TextureLookupEntry& PackIntoTextureArray(const Ref<Texture2D>& texture, TextureLookupEntry& entry)
+	{
+		const uint32_t width = texture->GetWidth();
+		const uint32_t height = texture->GetHeight();
+		if (width > Renderer2DData::MaxTextureArrayLayerSize || height > Renderer2DData::MaxTextureArrayLayerSize)
+			return entry;
+
+		int32_t pageIndex = -1;
+		int32_t emptyIndex = -1;
+		uint32_t sizeClassPages = 0;
+		for (size_t i = 0; i < s_Data.TextureArrayPages.size(); i++)
+		{
+			const TextureArrayPage& page = s_Data.TextureArrayPages[i];
+			if (!page.Array)
+			{
+				if (emptyIndex == -1)
+					emptyIndex = (int32_t)i;
+				continue;
+			}
+
+			if (!page.Array->CanHold(*texture))
+				continue;
+
+			sizeClassPages++;
+			if (!page.FreeLayers.empty())
+			{
+				pageIndex = (int32_t)i;
+				break;
+			}
+		}
+
+		if (pageIndex == -1)
+		{
+			// Pages of a size class start small and double, up to what fits in the page budget, so a size only a few
+			// textures have does not take a whole budget. Sized from the texture's top level in its own format.
+			const uint32_t layerBytes = TextureImporter::GetRowCount(texture->GetFormat(), height) * TextureImporter::GetRowBytes(texture->GetFormat(), width);
+			const uint32_t maxLayerCount = std::clamp(Renderer2DData::TextureArrayPageBytes / layerBytes, 4u, 256u);
+			const uint32_t layerCount = std::min(4u << std::min(sizeClassPages, 6u), maxLayerCount);
+
+			TextureArrayPage page;
+			page.Array = Texture2DArray::Create(*texture, layerCount);
+			page.Layers.resize(layerCount);
+			for (uint32_t layer = layerCount; layer > 0; layer--)
+				page.FreeLayers.push_back(layer - 1);
+
+			if (emptyIndex == -1)
+			{
+				emptyIndex = (int32_t)s_Data.TextureArrayPages.size();
+				s_Data.TextureArrayPages.emplace_back();
+			}
+			pageIndex = emptyIndex;
+			s_Data.TextureArrayPages[pageIndex] = std::move(page);
+		}
+
+		TextureArrayPage& page = s_Data.TextureArrayPages[pageIndex];
+		uint32_t layer = page.FreeLayers.back();
+		page.FreeLayers.pop_back();
+
+		// The texture becomes a view of the layer, under a new renderer ID, so its entry moves there. Its old ID is free
+		// to be handed out again.
+		TextureLookupEntry moved = entry;
+		entry = TextureLookupEntry();
+		page.Array->SetLayer(layer, *texture);
+
+		TextureLookupEntry& result = LookupTexture(texture);
+		result = moved;
+		result.Page = pageIndex;
+		result.Layer = layer;
+
+		page.Layers[layer].Texture = texture;
+		page.Layers[layer].RendererID = texture->GetRendererID();
+		return result;
+	}
+
+	static void MapBatchRegions()
 	{
 		s_Data.QuadIndexCount = 0;
+		s_Data.QuadVertexBufferBase = (QuadVertex*)s_Data.QuadVertexBuffer->MapRegion();
 		s_Data.QuadVertexBufferPtr = s_Data.QuadVertexBufferBase;
 
+		s_Data.QuadInstanceCount = 0;
+		s_Data.QuadInstanceBufferBase = (QuadInstance*)s_Data.QuadInstanceBuffer->MapRegion();
+		s_Data.QuadInstanceBufferPtr = s_Data.QuadInstanceBufferBase;
+
 		s_Data.CircleIndexCount = 0;
+		s_Data.CircleVertexBufferBase = (CircleVertex*)s_Data.CircleVertexBuffer->MapRegion();
 		s_Data.CircleVertexBufferPtr = s_Data.CircleVertexBufferBase;
 
 		s_Data.LineVertexCount = 0;
+		s_Data.LineVertexBufferBase = (LineVertex*)s_Data.LineVertexBuffer->MapRegion();
 		s_Data.LineVertexBufferPtr = s_Data.LineVertexBufferBase;
+	}
+
+	void Renderer2D::StartBatch()
+	{
+		MapBatchRegions();
 
 		s_Data.TextureSlotIndex = 1;
+		s_Data.TextureArraySlotIndex = 0;
+		s_Data.TextureBatchGeneration++;
+
+		ReleaseExpiredTextureLayers();
+		s_Data.SpriteAtlas.ReleaseExpired();
 	}
 	
 	void Renderer2D::NextBatch()
@@ -278,6 +670,254 @@ namespace Sora {
 		StartBatch();
 	}
 
+	void Renderer2D::ContinueBatch()
+	{
+		if (!s_Data.MultiDrawIndirect || s_Data.HeldRegionCount + 1 >= s_Data.QuadVertexBuffer->GetRegionCount())
+		{
+			NextBatch();
+			return;
+		}
+
+		GeneratePendingVertices();
+		RecordRegionDraws();
+
+		// Only regions with something in them are held, the others are simply filled again.
+		if (s_Data.QuadIndexCount)
+			s_Data.QuadVertexBuffer->HoldRegion();
+		if (s_Data.QuadInstanceCount)
+			s_Data.QuadInstanceBuffer->HoldRegion();
+		if (s_Data.CircleIndexCount)
+			s_Data.CircleVertexBuffer->HoldRegion();
+		if (s_Data.LineVertexCount)
+			s_Data.LineVertexBuffer->HoldRegion();
+		s_Data.HeldRegionCount++;
+
+		// The bound textures stay, so texture indices already handed out remain valid.
+		MapBatchRegions();
+	}
+
+	static TextureLookupEntry& LookupTexture(const Ref<Texture2D>& texture)
+	{
+		uint32_t rendererID = texture->GetRendererID();
+		if (rendererID >= s_Data.TextureLookup.size())
+			s_Data.TextureLookup.resize(std::max<size_t>(rendererID + 1, s_Data.TextureLookup.size() * 2));
+
+		TextureLookupEntry& entry = s_Data.TextureLookup[rendererID];
+		if (entry.Owner != texture.get())
+		{
+			entry = TextureLookupEntry();
+			entry.Owner = texture.get();
+		}
+		return entry;
+	}
+
+	float Renderer2D::GetTextureIndex(const Ref<Texture2D>& texture)
+	{
+		TextureLookupEntry* lookup = &LookupTexture(texture);
+		if (!lookup->ArrayResolved && texture->IsLoaded())
+		{
+			// Streamed textures are bound on their own until their pixels have arrived. Once in a page, SetData() on
+			// the texture writes straight into its layer.
+			lookup->ArrayResolved = true;
+			lookup = &PackIntoTextureArray(texture, *lookup);
+		}
+
+		TextureLookupEntry& entry = *lookup;
+		if (entry.Page != -1)
+		{
+			TextureArrayPage& page = s_Data.TextureArrayPages[entry.Page];
+			if (page.BatchGeneration != s_Data.TextureBatchGeneration)
+			{
+				if (s_Data.TextureArraySlotIndex == Renderer2DData::MaxTextureArraySlots)
+					NextBatch();
+
+				page.BatchGeneration = s_Data.TextureBatchGeneration;
+				page.Slot = s_Data.TextureArraySlotIndex;
+				s_Data.TextureArraySlots[s_Data.TextureArraySlotIndex++] = page.Array;
+			}
+
+			return (float)((Renderer2DData::MaxTextureSlots + page.Slot) | (entry.Layer << Renderer2DData::TextureLayerShift));
+		}
+
+		if (entry.BatchGeneration != s_Data.TextureBatchGeneration)
+		{
+			if (s_Data.TextureSlotIndex == Renderer2DData::MaxTextureSlots)
+				NextBatch();
+
+			entry.BatchGeneration = s_Data.TextureBatchGeneration;
+			entry.Slot = s_Data.TextureSlotIndex;
+			s_Data.TextureSlots[s_Data.TextureSlotIndex++] = texture;
+		}
+
+		return (float)entry.Slot;
+	}
+
+	float Renderer2D::GetSpriteTextureIndex(const Ref<Texture2D>& texture, float tilingFactor, const glm::vec2*& textureCoords)
+	{
+		// Tiling relies on the sampler repeating the whole texture, which an atlas region cannot do.
+		if (tilingFactor != 1.0f || !texture->IsLoaded())
+			return GetTextureIndex(texture);
+
+		TextureLookupEntry& entry = LookupTexture(texture);
+		if (entry.AtlasGeneration != s_Data.SpriteAtlas.GetGeneration())
+		{
+			entry.AtlasRegion = s_Data.SpriteAtlas.Insert(texture).get();
+			entry.AtlasGeneration = s_Data.SpriteAtlas.GetGeneration();
+		}
+
+		if (!entry.AtlasRegion)
+			return GetTextureIndex(texture);
+
+		textureCoords = entry.AtlasRegion->GetTexCoords();
+		return GetTextureIndex(entry.AtlasRegion->GetTexture());
+	}
+
+	ShaderLibrary& Renderer2D::GetShaderLibrary()
+	{
+		return s_Data.Shaders;
+	}
+
+	TextureAtlas& Renderer2D::GetTextureAtlas()
+	{
+		return s_Data.SpriteAtlas;
+	}
+
+	static bool IsPlanar(const glm::mat4& transform)
+	{
+		// An instance only carries the XY part of the X and Y axes, anything tilted out of the plane needs real vertices.
+		return transform[0][2] == 0.0f && transform[1][2] == 0.0f;
+	}
+
+	static void WriteQuadInstance(QuadInstance& instance, const glm::mat4& transform, const glm::vec4& color, const glm::vec2& texCoordMin, const glm::vec2& texCoordMax, float textureIndex, float tilingFactor, int entityID)
+	{
+		instance.Basis = { transform[0][0], transform[0][1], transform[1][0], transform[1][1] };
+		instance.Translation = transform[3];
+		instance.Color = glm::packUnorm4x8(color);
+		instance.TexCoordMin = glm::packUnorm2x16(texCoordMin);
+		instance.TexCoordMax = glm::packUnorm2x16(texCoordMax);
+		instance.TexIndex = (int)textureIndex;
+		instance.TilingFactor = tilingFactor;
+		instance.EntityID = entityID;
+	}
+
+	static void SubmitQuadInstance(const glm::mat4& transform, const glm::vec4& color, const glm::vec2* textureCoords, float textureIndex, float tilingFactor, int entityID)
+	{
+		WriteQuadInstance(*s_Data.QuadInstanceBufferPtr, transform, color, textureCoords[0], textureCoords[2], textureIndex, tilingFactor, entityID);
+		s_Data.QuadInstanceBufferPtr++;
+
+		s_Data.QuadInstanceCount++;
+
+		s_Data.Stats.QuadCount++;
+		s_Data.Stats.InstancedQuadCount++;
+	}
+
+	static void WriteQuadVertices(const PendingQuad* const* quads, const glm::mat4* const* transforms, size_t count)
+	{
+		glm::vec3 corners[Renderer2DData::QuadTransformBlockSize * 4];
+		Math::TransformQuads(transforms, count, corners);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const PendingQuad& quad = *quads[i];
+			const glm::vec2 textureCoords[] = {
+				quad.TexCoordMin, { quad.TexCoordMax.x, quad.TexCoordMin.y },
+				quad.TexCoordMax, { quad.TexCoordMin.x, quad.TexCoordMax.y }
+			};
+
+			QuadVertex* vertex = s_Data.QuadVertexBufferBase + quad.Destination;
+			for (size_t j = 0; j < 4; j++, vertex++)
+			{
+				vertex->Position = corners[i * 4 + j];
+				vertex->Color = quad.Color;
+				vertex->TexCoord = textureCoords[j];
+				vertex->TexIndex = quad.TexIndex;
+				vertex->TilingFactor = quad.TilingFactor;
+				vertex->EntityID = quad.EntityID;
+			}
+		}
+	}
+
+	void Renderer2D::GeneratePendingVertices()
+	{
+		if (s_Data.PendingQuads.empty() && s_Data.PendingCircles.empty())
+			return;
+
+		SORA_PROFILE_FUNCTION();
+
+		// Every pending primitive owns a disjoint slice of the mapped region, so chunks can be written concurrently.
+		JobSystem::ParallelFor(s_Data.PendingQuads.size(), Renderer2DData::VertexGenerationChunkSize, [](size_t begin, size_t end)
+			{
+				// Quads that take vertices are collected in blocks, whose corners come from the SIMD kernel.
+				const PendingQuad* block[Renderer2DData::QuadTransformBlockSize];
+				const glm::mat4* transforms[Renderer2DData::QuadTransformBlockSize];
+				size_t blockCount = 0;
+
+				for (size_t i = begin; i < end; i++)
+				{
+					const PendingQuad& quad = s_Data.PendingQuads[i];
+					if (quad.Instanced)
+					{
+						WriteQuadInstance(s_Data.QuadInstanceBufferBase[quad.Destination], *quad.Transform, quad.Color,
+							quad.TexCoordMin, quad.TexCoordMax, quad.TexIndex, quad.TilingFactor, quad.EntityID);
+						continue;
+					}
+
+					block[blockCount] = &quad;
+					transforms[blockCount] = quad.Transform;
+					if (++blockCount == Renderer2DData::QuadTransformBlockSize)
+					{
+						WriteQuadVertices(block, transforms, blockCount);
+						blockCount = 0;
+					}
+				}
+
+				if (blockCount > 0)
+					WriteQuadVertices(block, transforms, blockCount);
+			});
+
+		JobSystem::ParallelFor(s_Data.PendingCircles.size(), Renderer2DData::VertexGenerationChunkSize, [](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					const PendingCircle& circle = s_Data.PendingCircles[i];
+
+					CircleVertex* vertex = s_Data.CircleVertexBufferBase + circle.Destination;
+					for (size_t j = 0; j < 4; j++, vertex++)
+					{
+						vertex->WorldPosition = *circle.Transform * s_Data.QuadVertexPosition[j];
+						vertex->LocalPosition = s_Data.QuadVertexPosition[j] * 2.0f;
+						vertex->Color = circle.Circle->Color;
+						vertex->Thickness = circle.Circle->Thickness;
+						vertex->Fade = circle.Circle->Fade;
+						vertex->EntityID = circle.EntityID;
+					}
+				}
+			});
+
+		s_Data.PendingQuads.clear();
+		s_Data.PendingCircles.clear();
+	}
+
+	void Renderer2D::SetQuadInstancing(bool enabled)
+	{
+		s_Data.QuadInstancing = enabled;
+	}
+
+	bool Renderer2D::GetQuadInstancing()
+	{
+		return s_Data.QuadInstancing;
+	}
+
+	void Renderer2D::SetMultiDrawIndirect(bool enabled)
+	{
+		s_Data.MultiDrawIndirect = enabled;
+	}
+
+	bool Renderer2D::GetMultiDrawIndirect()
+	{
+		return s_Data.MultiDrawIndirect;
+	}
+
 	//////////////////
 	//				//
 	//	   DRAW		//
@@ -289,33 +929,18 @@ namespace Sora {
 		SORA_PROFILE_FUNCTION();
 
 		constexpr size_t quadVertexCount = 4;
-		constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+		constexpr glm::vec2 quadTexCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+		const glm::vec2* textureCoords = quadTexCoords;
 
-		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
-			NextBatch();
+		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices || s_Data.QuadInstanceCount >= Renderer2DData::MaxQuads)
+			ContinueBatch();
 
-		float textureIndex = -1.0f;
-		if (src.Texture)
-		{
-			for (uint32_t i = 1; i < s_Data.TextureSlotIndex; i++)
-			{
-				if (*s_Data.TextureSlots[i].get() == *src.Texture.get())
-				{
-					textureIndex = (float)i;
-					break;
-				}
-			}
+		float textureIndex = src.Texture ? GetSpriteTextureIndex(src.Texture, src.TilingFactor, textureCoords) : 0.0f;
 
-			if (textureIndex == -1.0f)
-			{
-				textureIndex = (float)s_Data.TextureSlotIndex;
-				s_Data.TextureSlots[s_Data.TextureSlotIndex] = src.Texture;
-				s_Data.TextureSlotIndex++;
-			}
-		}
-		else
+		if (s_Data.QuadInstancing && IsPlanar(transform))
 		{
-			textureIndex = 0.0f;
+			SubmitQuadInstance(transform, src.Color, textureCoords, textureIndex, src.TilingFactor, entityID);
+			return;
 		}
 
 		for (size_t i = 0; i < quadVertexCount; i++)
@@ -334,6 +959,463 @@ namespace Sora {
 		s_Data.Stats.QuadCount++;
 	}
 
+	static float GetQueueDepth(const glm::mat4& transform)
+	{
+		glm::vec4 clip = s_Data.CameraBuffer.ViewProjection * transform[3];
+		return clip.w != 0.0f ? clip.z / clip.w : clip.z;
+	}
+
+	static bool IsInViewFrustum(const glm::mat4& transform)
+	{
+		glm::vec3 center, extents;
+		Math::GetQuadBounds(transform, center, extents);
+		if (!s_Data.ViewFrustum.Intersects(center, extents))
+		{
+			s_Data.Stats.CulledCount++;
+			return false;
+		}
+
+		s_Data.Stats.VisibleCount++;
+		return true;
+	}
+
+	// Through its colour or its texture. Textures still loading count as translucent until the streamer knows better.
+	static bool IsTranslucent(const SpriteRendererComponent& src)
+	{
+		return src.Color.a < 1.0f || (src.Texture && !src.Texture->IsOpaque());
+	}
+
+	void Renderer2D::SubmitSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID)
+	{
+		s_Data.SceneUsedQueue = true;
+
+		// Translucent sprites need sorting against everything else, so only opaque ones can be baked.
+		const bool translucent = IsTranslucent(src);
+		if (src.Static && !translucent)
+		{
+			SubmitStaticSprite(transform, src, entityID);
+			return;
+		}
+
+		if (!IsInViewFrustum(transform))
+			return;
+
+		RenderQueue2D::Command command;
+		command.Transform = transform;
+		command.Sprite = &src;
+		command.EntityID = entityID;
+
+		auto pipeline = s_Data.QuadInstancing && IsPlanar(transform) ? RenderQueue2D::Pipeline::QuadInstanced : RenderQueue2D::Pipeline::Quad;
+		uint32_t textureID = src.Texture ? src.Texture->GetRendererID() : 0;
+		s_Data.Queue.Submit(command, src.Layer, translucent, pipeline, textureID, GetQueueDepth(transform));
+	}
+
+	void Renderer2D::SubmitCircle(const glm::mat4& transform, CircleRendererComponent& src, int entityID)
+	{
+		s_Data.SceneUsedQueue = true;
+
+		if (!IsInViewFrustum(transform))
+			return;
+
+		RenderQueue2D::Command command;
+		command.Transform = transform;
+		command.Circle = &src;
+		command.EntityID = entityID;
+
+		s_Data.Queue.Submit(command, src.Layer, src.Color.a < 1.0f, RenderQueue2D::Pipeline::Circle, 0, GetQueueDepth(transform));
+	}
+
+	static bool FitsStaticBatch(const StaticSpriteBatch& batch, const StaticSprite& sprite, const Ref<Texture2D>& texture)
+	{
+		if (batch.Members.size() >= Renderer2DData::MaxStaticBatchQuads)
+			return false;
+
+		if (batch.Layer != sprite.Layer || batch.Cell != sprite.Cell)
+			return false;
+
+		if (!texture || std::find(batch.Textures.begin(), batch.Textures.end(), texture) != batch.Textures.end())
+			return true;
+
+		return batch.Textures.size() < Renderer2DData::MaxTextureSlots - 1;
+	}
+
+	static void RemoveFromStaticBatch(int entityID, uint32_t batchIndex)
+	{
+		StaticSpriteBatch& batch = s_Data.StaticBatches[batchIndex];
+		auto it = std::find(batch.Members.begin(), batch.Members.end(), entityID);
+		SORA_CORE_ASSERT(it != batch.Members.end(), "Static sprite is missing from its batch!");
+
+		*it = batch.Members.back();
+		batch.Members.pop_back();
+		batch.Dirty = true;
+	}
+
+	static void AddToStaticBatch(int entityID, StaticSprite& sprite)
+	{
+		// A batch of the same layer and cell, or else an empty one, so that sprites near each other are culled together.
+		uint32_t batchIndex = (uint32_t)s_Data.StaticBatches.size();
+		uint32_t emptyIndex = (uint32_t)s_Data.StaticBatches.size();
+		for (uint32_t i = 0; i < (uint32_t)s_Data.StaticBatches.size(); i++)
+		{
+			const StaticSpriteBatch& batch = s_Data.StaticBatches[i];
+			if (batch.Members.empty())
+			{
+				emptyIndex = std::min(emptyIndex, i);
+				continue;
+			}
+
+			if (FitsStaticBatch(batch, sprite, sprite.Texture))
+			{
+				batchIndex = i;
+				break;
+			}
+		}
+
+		if (batchIndex == s_Data.StaticBatches.size())
+			batchIndex = emptyIndex;
+
+		if (batchIndex == s_Data.StaticBatches.size())
+		{
+			StaticSpriteBatch& batch = s_Data.StaticBatches.emplace_back();
+			batch.VertexArray = VertexArray::Create();
+			batch.VertexBuffer = VertexBuffer::Create(Renderer2DData::MaxStaticBatchQuads * 4 * sizeof(QuadVertex), BufferUsage::Static);
+			batch.VertexBuffer->SetLayout(s_Data.QuadVertexBuffer->GetLayout());
+			batch.VertexArray->AddVertexBuffer(batch.VertexBuffer);
+			batch.VertexArray->SetIndexBuffer(s_Data.QuadIndexBuffer);
+		}
+
+		StaticSpriteBatch& batch = s_Data.StaticBatches[batchIndex];
+		batch.Layer = sprite.Layer;
+		batch.Cell = sprite.Cell;
+		batch.Members.push_back(entityID);
+		if (sprite.Texture && std::find(batch.Textures.begin(), batch.Textures.end(), sprite.Texture) == batch.Textures.end())
+			batch.Textures.push_back(sprite.Texture);
+		batch.Dirty = true;
+
+		sprite.Batch = batchIndex;
+	}
+
+	void Renderer2D::SubmitStaticSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID)
+	{
+		auto [it, inserted] = s_Data.StaticSprites.try_emplace(entityID);
+		StaticSprite& sprite = it->second;
+
+		if (sprite.LastScene != s_Data.SceneIndex)
+		{
+			sprite.LastScene = s_Data.SceneIndex;
+			s_Data.StaticSpritesSeen++;
+		}
+
+		const int layer = glm::clamp(src.Layer, RenderQueue2D::MinLayer, RenderQueue2D::MaxLayer);
+		if (!inserted && sprite.Transform == transform && sprite.Color == src.Color && sprite.Texture == src.Texture &&
+			sprite.TilingFactor == src.TilingFactor && sprite.Layer == layer)
+			return;
+
+		sprite.Transform = transform;
+		sprite.Color = src.Color;
+		sprite.TilingFactor = src.TilingFactor;
+		sprite.Layer = layer;
+		sprite.Cell.x = (int)std::floor(transform[3].x / Renderer2DData::StaticBatchCellSize);
+		sprite.Cell.y = (int)std::floor(transform[3].y / Renderer2DData::StaticBatchCellSize);
+
+		if (!inserted)
+		{
+			// Staying in the batch needs the same layer and cell, which FitsStaticBatch() checks along with the room.
+			StaticSpriteBatch& batch = s_Data.StaticBatches[sprite.Batch];
+			if ((sprite.Texture == src.Texture && batch.Layer == sprite.Layer && batch.Cell == sprite.Cell) || FitsStaticBatch(batch, sprite, src.Texture))
+			{
+				sprite.Texture = src.Texture;
+				if (sprite.Texture && std::find(batch.Textures.begin(), batch.Textures.end(), sprite.Texture) == batch.Textures.end())
+					batch.Textures.push_back(sprite.Texture);
+				batch.Dirty = true;
+				return;
+			}
+
+			RemoveFromStaticBatch(entityID, sprite.Batch);
+		}
+
+		sprite.Texture = src.Texture;
+		AddToStaticBatch(entityID, sprite);
+	}
+
+	static void RebuildStaticBatch(StaticSpriteBatch& batch)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+
+		// Textures of sprites that left the batch are dropped here.
+		batch.Textures.clear();
+
+		std::vector<const StaticSprite*> sprites(batch.Members.size());
+		std::vector<const glm::mat4*> transforms(batch.Members.size());
+		for (size_t i = 0; i < batch.Members.size(); i++)
+		{
+			sprites[i] = &s_Data.StaticSprites.at(batch.Members[i]);
+			transforms[i] = &sprites[i]->Transform;
+		}
+
+		std::vector<glm::vec3> corners(batch.Members.size() * 4);
+		Math::TransformQuads(transforms.data(), transforms.size(), corners.data());
+
+		std::vector<QuadVertex> vertices(batch.Members.size() * 4);
+		glm::vec3 boundsMin(std::numeric_limits<float>::max());
+		glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+
+		QuadVertex* vertex = vertices.data();
+		const glm::vec3* corner = corners.data();
+		for (size_t member = 0; member < batch.Members.size(); member++)
+		{
+			const StaticSprite& sprite = *sprites[member];
+
+			float textureIndex = 0.0f;
+			if (sprite.Texture)
+			{
+				auto it = std::find(batch.Textures.begin(), batch.Textures.end(), sprite.Texture);
+				textureIndex = (float)(it - batch.Textures.begin() + 1);
+				if (it == batch.Textures.end())
+					batch.Textures.push_back(sprite.Texture);
+			}
+
+			for (size_t i = 0; i < 4; i++, vertex++, corner++)
+			{
+				vertex->Position = *corner;
+				vertex->Color = sprite.Color;
+				vertex->TexCoord = textureCoords[i];
+				vertex->TexIndex = textureIndex;
+				vertex->TilingFactor = sprite.TilingFactor;
+				vertex->EntityID = batch.Members[member];
+
+				boundsMin = glm::min(boundsMin, vertex->Position);
+				boundsMax = glm::max(boundsMax, vertex->Position);
+			}
+		}
+
+		uint32_t dataSize = (uint32_t)(vertices.size() * sizeof(QuadVertex));
+		batch.VertexBuffer->SetData(vertices.data(), dataSize);
+		batch.BoundsCenter = (boundsMin + boundsMax) * 0.5f;
+		batch.BoundsExtents = (boundsMax - boundsMin) * 0.5f;
+		batch.Dirty = false;
+
+		s_Data.Stats.UploadedBytes += dataSize;
+		s_Data.Stats.StaticBatchRebuilds++;
+	}
+
+	void Renderer2D::UpdateStaticBatches()
+	{
+		s_Data.StaticLayers.clear();
+
+		// Scenes drawn without the queue, like the editor overlay, say nothing about which static sprites still exist.
+		if (!s_Data.SceneUsedQueue)
+			return;
+
+		SORA_PROFILE_FUNCTION();
+
+		// Static sprites that were not submitted this time have been destroyed or stopped being static.
+		if (s_Data.StaticSpritesSeen != s_Data.StaticSprites.size())
+		{
+			for (auto it = s_Data.StaticSprites.begin(); it != s_Data.StaticSprites.end();)
+			{
+				if (it->second.LastScene == s_Data.SceneIndex)
+				{
+					++it;
+					continue;
+				}
+
+				RemoveFromStaticBatch(it->first, it->second.Batch);
+				it = s_Data.StaticSprites.erase(it);
+			}
+		}
+
+		for (StaticSpriteBatch& batch : s_Data.StaticBatches)
+		{
+			if (batch.Members.empty())
+			{
+				// Left empty for sprites to come, without holding on to the textures of the ones that left.
+				batch.Textures.clear();
+				continue;
+			}
+
+			if (batch.Dirty)
+				RebuildStaticBatch(batch);
+
+			s_Data.StaticLayers.push_back(batch.Layer);
+		}
+
+		std::sort(s_Data.StaticLayers.begin(), s_Data.StaticLayers.end());
+		s_Data.StaticLayers.erase(std::unique(s_Data.StaticLayers.begin(), s_Data.StaticLayers.end()), s_Data.StaticLayers.end());
+
+		s_Data.SceneIndex++;
+		s_Data.StaticSpritesSeen = 0;
+		s_Data.SceneUsedQueue = false;
+	}
+
+	void Renderer2D::DrawStaticBatches(int layer)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		for (const StaticSpriteBatch& batch : s_Data.StaticBatches)
+		{
+			if (batch.Members.empty() || batch.Layer != layer)
+				continue;
+
+			const uint32_t quadCount = (uint32_t)batch.Members.size();
+			if (!s_Data.ViewFrustum.Intersects(batch.BoundsCenter, batch.BoundsExtents))
+			{
+				s_Data.Stats.CulledCount += quadCount;
+				continue;
+			}
+
+			s_Data.WhiteTexture->Bind(0);
+			for (uint32_t i = 0; i < (uint32_t)batch.Textures.size(); i++)
+				batch.Textures[i]->Bind(i + 1);
+
+			s_Data.QuadShader->Bind();
+			RenderCommand::DrawIndexed(batch.VertexArray, quadCount * 6);
+
+			s_Data.Stats.DrawCallCount++;
+			s_Data.Stats.QuadCount += quadCount;
+			s_Data.Stats.StaticQuadCount += quadCount;
+			s_Data.Stats.VisibleCount += quadCount;
+		}
+	}
+
+	static bool IsBatchEmpty()
+	{
+		return s_Data.QuadIndexCount == 0 && s_Data.QuadInstanceCount == 0 && s_Data.CircleIndexCount == 0 &&
+			s_Data.LineVertexCount == 0 && s_Data.HeldRegionCount == 0;
+	}
+
+	void Renderer2D::DrawQueue()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		if (s_Data.Queue.IsEmpty() && s_Data.StaticLayers.empty())
+			return;
+
+		const std::vector<uint32_t>& order = s_Data.Queue.Sort();
+
+		// Static batches are opaque and drawn first in their layer, after whatever the batch holds of the layers below.
+		auto staticLayer = s_Data.StaticLayers.begin();
+		bool depthWrite = true;
+		auto drawStaticLayers = [&](int layer)
+			{
+				if (staticLayer == s_Data.StaticLayers.end() || *staticLayer > layer)
+					return;
+
+				if (!IsBatchEmpty())
+					NextBatch();
+				if (!depthWrite)
+				{
+					depthWrite = true;
+					RenderCommand::SetDepthWrite(true);
+				}
+
+				for (; staticLayer != s_Data.StaticLayers.end() && *staticLayer <= layer; ++staticLayer)
+					DrawStaticBatches(*staticLayer);
+			};
+
+		uint64_t previousKey = order.empty() ? 0 : s_Data.Queue.GetKey(order[0]);
+		for (uint32_t index : order)
+		{
+			uint64_t key = s_Data.Queue.GetKey(index);
+			drawStaticLayers(RenderQueue2D::GetLayer(key));
+
+			// Translucent work is drawn back to front without writing depth, so it never hides what is drawn after it
+			// at the same depth, on its own layer or a higher one.
+			if (RenderQueue2D::IsTranslucent(key) == depthWrite)
+			{
+				NextBatch();
+				depthWrite = !depthWrite;
+				RenderCommand::SetDepthWrite(depthWrite);
+			}
+			// A batch draws its quads, instanced quads and circles one kind after the other. Where order matters, for
+			// translucent work and across layers, a change of pipeline has to close the batch first.
+			else if (RenderQueue2D::GetPipeline(key) != RenderQueue2D::GetPipeline(previousKey) &&
+				(RenderQueue2D::IsTranslucent(key) || RenderQueue2D::GetLayer(key) != RenderQueue2D::GetLayer(previousKey)))
+				NextBatch();
+			previousKey = key;
+
+			const RenderQueue2D::Command& command = s_Data.Queue.GetCommand(index);
+			if (command.Sprite)
+				DeferSprite(command.Transform, *command.Sprite, command.EntityID);
+			else
+				DeferCircle(command.Transform, *command.Circle, command.EntityID);
+		}
+
+		// Pending work points into the queue, so it has to be written out before the queue is cleared.
+		if (!depthWrite)
+		{
+			NextBatch();
+			RenderCommand::SetDepthWrite(true);
+			depthWrite = true;
+		}
+		else
+			GeneratePendingVertices();
+
+		drawStaticLayers(RenderQueue2D::MaxLayer);
+
+		s_Data.Stats.StateChangesAvoided += (int32_t)s_Data.Queue.GetSubmittedStateChanges() - (int32_t)s_Data.Queue.GetSortedStateChanges();
+		s_Data.Queue.Clear();
+	}
+
+	void Renderer2D::DeferSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID)
+	{
+		constexpr glm::vec2 quadTexCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+		const glm::vec2* textureCoords = quadTexCoords;
+
+		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices || s_Data.QuadInstanceCount >= Renderer2DData::MaxQuads)
+			ContinueBatch();
+
+		float textureIndex = src.Texture ? GetSpriteTextureIndex(src.Texture, src.TilingFactor, textureCoords) : 0.0f;
+
+		PendingQuad& quad = s_Data.PendingQuads.emplace_back();
+		quad.Transform = &transform;
+		quad.Color = src.Color;
+		quad.TexCoordMin = textureCoords[0];
+		quad.TexCoordMax = textureCoords[2];
+		quad.TexIndex = textureIndex;
+		quad.TilingFactor = src.TilingFactor;
+		quad.EntityID = entityID;
+
+		if (s_Data.QuadInstancing && IsPlanar(transform))
+		{
+			quad.Instanced = true;
+			quad.Destination = s_Data.QuadInstanceCount;
+
+			s_Data.QuadInstanceBufferPtr++;
+			s_Data.QuadInstanceCount++;
+			s_Data.Stats.InstancedQuadCount++;
+		}
+		else
+		{
+			quad.Instanced = false;
+			quad.Destination = (uint32_t)(s_Data.QuadVertexBufferPtr - s_Data.QuadVertexBufferBase);
+
+			s_Data.QuadVertexBufferPtr += 4;
+			s_Data.QuadIndexCount += 6;
+		}
+
+		s_Data.Stats.QuadCount++;
+	}
+
+	void Renderer2D::DeferCircle(const glm::mat4& transform, CircleRendererComponent& src, int entityID)
+	{
+		if (s_Data.CircleIndexCount >= Renderer2DData::MaxIndices)
+			ContinueBatch();
+
+		PendingCircle& circle = s_Data.PendingCircles.emplace_back();
+		circle.Transform = &transform;
+		circle.Circle = &src;
+		circle.EntityID = entityID;
+		circle.Destination = (uint32_t)(s_Data.CircleVertexBufferPtr - s_Data.CircleVertexBufferBase);
+
+		s_Data.CircleVertexBufferPtr += 4;
+		s_Data.CircleIndexCount += 6;
+
+		s_Data.Stats.QuadCount++;
+	}
+
 	void Renderer2D::DrawCircle(const glm::mat4& transform, CircleRendererComponent& src, int entityID)
 	{
 		DrawCircle(transform, src.Color, src.Thickness, src.Fade, entityID);
@@ -344,7 +1426,7 @@ namespace Sora {
 		SORA_PROFILE_FUNCTION();
 
 		if (s_Data.CircleIndexCount >= Renderer2DData::MaxIndices)
-			NextBatch();
+			ContinueBatch();
 
 		for (size_t i = 0; i < 4; i++)
 		{
@@ -458,30 +1540,21 @@ namespace Sora {
 		const glm::vec2* textureCoords = subtexture->GetTexCoords();
 		const Ref<Texture2D> texture = subtexture->GetTexture();
 
-		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
-			NextBatch();
-
-		float textureIndex = 0.0f;
-		for (uint32_t i = 1; i < s_Data.TextureSlotIndex; i++)
-		{
-			if (*s_Data.TextureSlots[i].get() == *texture.get())
-			{
-				textureIndex = (float)i;
-				break;
-			}
-		}
+		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices || s_Data.QuadInstanceCount >= Renderer2DData::MaxQuads)
+			ContinueBatch();
 
-		if (textureIndex == 0.0f)
-		{
-			textureIndex = (float)s_Data.TextureSlotIndex;
-			s_Data.TextureSlots[s_Data.TextureSlotIndex] = texture;
-			s_Data.TextureSlotIndex++;
-		}
+		float textureIndex = GetTextureIndex(texture);
 
 		glm::mat4 transform = glm::translate(glm::mat4(1.0f), position);
 		if (rotation != 0.0f) transform *= glm::rotate(glm::mat4(1.0f), rotation, { 0.0f, 0.0f, 1.0f });
 		transform *= glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
 
+		if (s_Data.QuadInstancing && IsPlanar(transform))
+		{
+			SubmitQuadInstance(transform, color, textureCoords, textureIndex, tilingFactor, -1);
+			return;
+		}
+
 		for (size_t i = 0; i < quadVertexCount; i++)
 		{
 			s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPosition[i];
@@ -507,8 +1580,14 @@ namespace Sora {
 		const float textureIndex = 0.0f;
 		const float tilingFactor = 1.0f;
 
-		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
-			NextBatch();
+		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices || s_Data.QuadInstanceCount >= Renderer2DData::MaxQuads)
+			ContinueBatch();
+
+		if (s_Data.QuadInstancing && IsPlanar(transform))
+		{
+			SubmitQuadInstance(transform, color, textureCoords, textureIndex, tilingFactor, entity_id);
+			return;
+		}
 
 		for (size_t i = 0; i < quadVertexCount; i++)
 		{
@@ -532,26 +1611,18 @@ namespace Sora {
 
 		constexpr size_t quadVertexCount = 4;
 		constexpr glm::vec4 color = { 1.0f, 1.0f, 1.0f, 1.0f };
-		constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+		constexpr glm::vec2 quadTexCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+		const glm::vec2* textureCoords = quadTexCoords;
 
-		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
-			NextBatch();
+		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices || s_Data.QuadInstanceCount >= Renderer2DData::MaxQuads)
+			ContinueBatch();
 
-		float textureIndex = 0.0f;
-		for (uint32_t i = 1; i < s_Data.TextureSlotIndex; i++)
-		{
-			if (*s_Data.TextureSlots[i].get() == *texture.get())
-			{
-				textureIndex = (float)i;
-				break;
-			}
-		}
+		float textureIndex = GetSpriteTextureIndex(texture, tiling_factor, textureCoords);
 
-		if (textureIndex == 0.0f)
+		if (s_Data.QuadInstancing && IsPlanar(transform))
 		{
-			textureIndex = (float)s_Data.TextureSlotIndex;
-			s_Data.TextureSlots[s_Data.TextureSlotIndex] = texture;
-			s_Data.TextureSlotIndex++;
+			SubmitQuadInstance(transform, tint_color, textureCoords, textureIndex, tiling_factor, entity_id);
+			return;
 		}
 
 		for (size_t i = 0; i < quadVertexCount; i++)
@@ -6,6 +6,8 @@
 
 #include "Sora/Renderer/Texture.h"
 #include "Sora/Renderer/SubTexture2D.h"
+#include "Sora/Renderer/TextureAtlas.h"
+#include "Sora/Renderer/Shader.h"
 
 #include "Sora/Scene/Component.h"
 
@@ -25,9 +27,25 @@ namespace Sora {
 
 		static void DrawSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID);
 
+		// Queued variants of DrawSprite() and DrawCircle(). Submissions are ordered by layer, translucency, pipeline,
+		// texture and depth (translucent ones back to front) and drawn at EndScene(), with their vertices generated on
+		// worker threads. Submissions outside the camera's view frustum are culled. Opaque sprites marked Static are
+		// kept in retained batches instead, see SubmitStaticSprite().
+		static void SubmitSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID);
+		static void SubmitCircle(const glm::mat4& transform, CircleRendererComponent& src, int entityID);
+
 		static void DrawCircle(const glm::mat4& transform, CircleRendererComponent& src, int entityID);
 		static void DrawCircle(const glm::mat4& transform, const glm::vec4& color, float thickness = 1.0f, float fade = 0.005f, int entityID = -1);
 
+		// Quads with a transform in the XY plane are sent as one instance record each instead of four vertices.
+		static void SetQuadInstancing(bool enabled);
+		static bool GetQuadInstancing();
+
+		// Batches that only ran out of room keep their textures and are drawn together, one multi-draw-indirect call
+		// per primitive type, instead of flushing each one on its own.
+		static void SetMultiDrawIndirect(bool enabled);
+		static bool GetMultiDrawIndirect();
+
 		static void DrawLine(const glm::vec3& point1, const glm::vec3& point2, const glm::vec4& color, int entityID = -1);
 		static void SetLineWidth(float width);
 		static float GetLineWidth();
@@ -49,15 +67,51 @@ namespace Sora {
 		{
 			uint32_t DrawCallCount = 0;
 			uint32_t QuadCount = 0;
+			uint32_t InstancedQuadCount = 0;
+			uint64_t UploadedBytes = 0;
+			int32_t StateChangesAvoided = 0;	// By sorting the render queue, negative if sorting cost switches.
+			uint32_t VisibleCount = 0;			// Sprites and circles submitted inside the view frustum.
+			uint32_t CulledCount = 0;
+			uint32_t StaticQuadCount = 0;		// Drawn from retained static batches, included in QuadCount.
+			uint32_t StaticBatchRebuilds = 0;
+			uint32_t IndirectDrawCount = 0;		// Batches drawn through multi-draw-indirect calls.
 
 			uint32_t GetTotalVertexCount() const { return QuadCount * 4; }
 			uint32_t GetTotalIndexCount() const { return QuadCount * 6; }
 		};
 		static void ResetStats();
 		static Statistics GetStats();
+
+		// Small sprite textures are packed here the first time they are drawn, or up front by calling Insert().
+		static TextureAtlas& GetTextureAtlas();
+
+		// The shaders of the renderer, by name, for hot reloading.
+		static ShaderLibrary& GetShaderLibrary();
 	private:
 		static void StartBatch();
 		static void NextBatch();
+		// Used when the current batch is full: moves on to fresh stream regions without flushing, if enough are left.
+		static void ContinueBatch();
+		static void DrawQueue();
+
+		// Static sprites are baked, by entity ID, into GPU buffers that are only rebuilt when a member changes, joins or
+		// leaves. A batch holds sprites of one layer and one cell of a grid, is culled as a whole, and is drawn by
+		// DrawQueue() ahead of the queued work of its layer.
+		static void SubmitStaticSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID);
+		static void UpdateStaticBatches();
+		static void DrawStaticBatches(int layer);
+
+		// Reserve room in the current batch and leave the vertices to GeneratePendingVertices(), which fills them in
+		// parallel before the batch is flushed.
+		static void DeferSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID);
+		static void DeferCircle(const glm::mat4& transform, CircleRendererComponent& src, int entityID);
+		static void GeneratePendingVertices();
+
+		// Binds the texture (or the texture array page holding it) for the current batch, starting a new batch when
+		// all slots are taken.
+		static float GetTextureIndex(const Ref<Texture2D>& texture);
+		// Same as GetTextureIndex(), but redirects to the texture's atlas region when it has one.
+		static float GetSpriteTextureIndex(const Ref<Texture2D>& texture, float tilingFactor, const glm::vec2*& textureCoords);
 	};
 
 }
\ No newline at end of file
@@ -5,6 +5,25 @@
 
 namespace Sora {
 
+	// One draw of a multi-draw, laid out the way the GPU reads it from the indirect buffer.
+	struct DrawIndexedIndirectCommand
+	{
+		uint32_t IndexCount;
+		uint32_t InstanceCount;
+		uint32_t FirstIndex;
+		int32_t BaseVertex;
+		uint32_t BaseInstance;
+	};
+
+	// The same for draws without indices.
+	struct DrawArraysIndirectCommand
+	{
+		uint32_t VertexCount;
+		uint32_t InstanceCount;
+		uint32_t FirstVertex;
+		uint32_t BaseInstance;
+	};
+
 	class RendererAPI
 	{
 	public:
@@ -18,10 +37,14 @@ namespace Sora {
 		virtual void SetClearColor(const glm::vec4& color) = 0;
 		virtual void Clear() = 0;
 
-		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, std::optional<uint32_t> indexCount = std::nullopt) = 0;
-		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) = 0;
+		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, std::optional<uint32_t> indexCount = std::nullopt, uint32_t baseVertex = 0) = 0;
+		virtual void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t baseInstance = 0) = 0;
+		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t firstVertex = 0) = 0;
+		virtual void MultiDrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const DrawIndexedIndirectCommand* commands, uint32_t drawCount) = 0;
+		virtual void MultiDrawLinesIndirect(const Ref<VertexArray>& vertexArray, const DrawArraysIndirectCommand* commands, uint32_t drawCount) = 0;
 
 		virtual void SetLineWidth(float width) = 0;
+		virtual void SetDepthWrite(bool enabled) = 0;
 	
 		inline static API GetAPI() { return s_API; }
 	private:
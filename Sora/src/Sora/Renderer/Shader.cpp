@@ -4,6 +4,12 @@
 #include "Renderer.h"
 #include "Platform/OpenGL/OpenGLShader.h"
 
+#include "Sora/Core/Timer.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 namespace Sora {
 
 	Ref<Shader> Shader::Create(const std::string& filepath)
@@ -27,10 +33,125 @@ namespace Sora {
 		return nullptr;
 	}
 
+	std::vector<Ref<Shader>> Shader::Create(const std::vector<std::string>& filepaths)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:	SORA_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return {};
+			case RendererAPI::API::OpenGL:	return OpenGLShader::CreateAll(filepaths);
+		}
+
+		SORA_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return {};
+	}
+
+	// Polls the modification times of the watched files, and compiles changed shaders on its own thread. Programs are
+	// only created and swapped by ShaderLibrary::OnUpdate() on the render thread, which owns the GL context.
+	struct ShaderLibrary::Watcher
+	{
+		struct Entry
+		{
+			Ref<Sora::Shader> Shader;
+			std::filesystem::file_time_type LastWriteTime;
+			bool Pending = false;	// Compiled or compiling, and not yet finished on the render thread.
+		};
+
+		struct Result
+		{
+			Ref<Sora::Shader> Shader;
+			bool Compiled;
+			float CompileMilliseconds;
+			Timer SinceChange;
+		};
+
+		static constexpr auto PollInterval = std::chrono::milliseconds(250);
+
+		std::mutex Mutex;
+		std::condition_variable Wake;
+		bool Running = true;
+		std::vector<Entry> Entries;
+		std::vector<Result> Ready;
+		std::thread Thread;
+
+		Watcher()
+		{
+			Thread = std::thread([this]() { Run(); });
+		}
+
+		~Watcher()
+		{
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				Running = false;
+			}
+			Wake.notify_one();
+			Thread.join();
+		}
+
+		void Watch(const Ref<Sora::Shader>& shader)
+		{
+			const std::string& filepath = shader->GetFilepath();
+			if (filepath.empty())
+				return;
+
+			std::error_code error;
+			auto time = std::filesystem::last_write_time(filepath, error);
+
+			std::lock_guard<std::mutex> lock(Mutex);
+			Entries.push_back({ shader, time });
+		}
+
+		void Run()
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			while (Running)
+			{
+				Wake.wait_for(lock, PollInterval);
+				if (!Running)
+					break;
+
+				for (size_t i = 0; i < Entries.size() && Running; i++)
+				{
+					Entry& entry = Entries[i];
+					if (entry.Pending)
+						continue;
+
+					// Editors may replace the file while saving, missing files are skipped until they are back.
+					std::error_code error;
+					auto time = std::filesystem::last_write_time(entry.Shader->GetFilepath(), error);
+					if (error || time == entry.LastWriteTime)
+						continue;
+
+					entry.LastWriteTime = time;
+					entry.Pending = true;
+					Ref<Sora::Shader> shader = entry.Shader;
+
+					// Entries may grow while unlocked, so only the copied reference is used past this point.
+					lock.unlock();
+					Timer since_change;
+					Timer timer;
+					bool compiled = shader->CompileReload();
+					float compile_ms = timer.ElapsedMillis();
+					lock.lock();
+
+					Ready.push_back({ shader, compiled, compile_ms, since_change });
+				}
+			}
+		}
+	};
+
+	ShaderLibrary::ShaderLibrary() = default;
+	ShaderLibrary::~ShaderLibrary() = default;
+	ShaderLibrary::ShaderLibrary(ShaderLibrary&&) noexcept = default;
+	ShaderLibrary& ShaderLibrary::operator=(ShaderLibrary&&) noexcept = default;
+
 	void ShaderLibrary::Add(const std::string& name, const Ref<Shader>& shader)
 	{
 		SORA_CORE_ASSERT(!IsExist(name), "Shader '{0}' already exists!", name);
 		m_Shaders[name] = shader;
+
+		if (m_Watcher)
+			m_Watcher->Watch(shader);
 	}
 
 	void ShaderLibrary::Add(const Ref<Shader>& shader)
@@ -64,4 +185,64 @@ namespace Sora {
 		return m_Shaders.find(name) != m_Shaders.end();
 	}
 
+	void ShaderLibrary::SetHotReload(bool enabled)
+	{
+		if (enabled == IsHotReloadEnabled())
+			return;
+
+		if (!enabled)
+		{
+			m_Watcher.reset();
+			return;
+		}
+
+		m_Watcher = CreateScope<Watcher>();
+		for (auto&& [name, shader] : m_Shaders)
+			m_Watcher->Watch(shader);
+	}
+
+	void ShaderLibrary::OnUpdate()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		if (!m_Watcher)
+			return;
+
+		std::vector<Watcher::Result> ready;
+		{
+			std::lock_guard<std::mutex> lock(m_Watcher->Mutex);
+			std::swap(ready, m_Watcher->Ready);
+		}
+
+		if (ready.empty())
+			return;
+
+		for (Watcher::Result& result : ready)
+		{
+			// FinishReload() consumes the compiled shader even when compilation failed, and never drops the current
+			// program unless the new one linked.
+			bool succeeded = result.Shader->FinishReload() && result.Compiled;
+
+			ReloadRecord record = { result.Shader->GetName(), succeeded, result.CompileMilliseconds, result.SinceChange.ElapsedMillis() };
+			if (succeeded)
+				SORA_CORE_INFO("Hot reloaded shader '{0}' in {1:.2f}ms ({2:.2f}ms compiling)", record.Name, record.TotalMilliseconds, record.CompileMilliseconds);
+			else
+				SORA_CORE_WARN("Hot reload of shader '{0}' failed, the previous program stays in use", record.Name);
+
+			m_ReloadHistory.push_back(record);
+			if (m_ReloadHistory.size() > 16)
+				m_ReloadHistory.pop_front();
+		}
+
+		std::lock_guard<std::mutex> lock(m_Watcher->Mutex);
+		for (Watcher::Entry& entry : m_Watcher->Entries)
+		{
+			for (const Watcher::Result& result : ready)
+			{
+				if (entry.Shader == result.Shader)
+					entry.Pending = false;
+			}
+		}
+	}
+
 }
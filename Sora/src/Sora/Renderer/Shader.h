@@ -2,10 +2,35 @@
 
 #include <string>
 #include <unordered_map>
+#include <deque>
 #include <glm/glm.hpp>
 
 namespace Sora {
 
+	// A uniform location resolved once through Shader::GetUniform(), so that setting it needs no name lookup. The type
+	// picks the matching Shader::Set() overload at compile time.
+	template<typename T>
+	struct ShaderUniform
+	{
+		int32_t Location = -1;
+
+		bool IsValid() const { return Location != -1; }
+	};
+
+	struct ShaderUniformBlock
+	{
+		struct Member
+		{
+			std::string Name;
+			uint32_t Offset;
+		};
+
+		std::string Name;
+		uint32_t Binding;
+		uint32_t Size;
+		std::vector<Member> Members;
+	};
+
 	class Shader
 	{
 	public:
@@ -14,6 +39,9 @@ namespace Sora {
 		virtual void Bind() const = 0;
 		virtual void Unbind() const = 0;
 
+		// Changes when a hot reload swaps in a new program.
+		virtual uint32_t GetRendererID() const = 0;
+
 		virtual void SetInt(const std::string& name, int value) = 0;
 		virtual void SetIntArray(const std::string& name, int* values, uint32_t count) = 0;
 		virtual void SetFloat(const std::string& name, float value) = 0;
@@ -21,15 +49,53 @@ namespace Sora {
 		virtual void SetFloat4(const std::string& name, const glm::vec4& value) = 0;
 		virtual void SetMat4(const std::string& name, const glm::mat4& value) = 0;
 
+		// -1 for names the shader does not use. Setting an invalid uniform does nothing.
+		virtual int32_t GetUniformLocation(const std::string& name) const = 0;
+		template<typename T>
+		ShaderUniform<T> GetUniform(const std::string& name) const { return { GetUniformLocation(name) }; }
+
+		// Do not need the shader to be bound.
+		virtual void Set(ShaderUniform<int> uniform, int value) = 0;
+		virtual void Set(ShaderUniform<int> uniform, const int* values, uint32_t count) = 0;
+		virtual void Set(ShaderUniform<float> uniform, float value) = 0;
+		virtual void Set(ShaderUniform<glm::vec3> uniform, const glm::vec3& value) = 0;
+		virtual void Set(ShaderUniform<glm::vec4> uniform, const glm::vec4& value) = 0;
+		virtual void Set(ShaderUniform<glm::mat4> uniform, const glm::mat4& value) = 0;
+
+		virtual const std::vector<ShaderUniformBlock>& GetUniformBlocks() const = 0;
+
 		virtual const std::string& GetName() const = 0;
+		// Empty for shaders created from sources.
+		virtual const std::string& GetFilepath() const = 0;
+
+		// Hot reload, in two steps. CompileReload() recompiles the file into a new program kept aside, and may run on
+		// any thread. FinishReload() links it on the render thread and swaps it in, or keeps the current program when
+		// anything failed. Uniforms resolved before a reload are stale after it.
+		virtual bool CompileReload() = 0;
+		virtual bool FinishReload() = 0;
 
 		static Ref<Shader> Create(const std::string& filepath);
 		static Ref<Shader> Create(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
+		// Compiles the shaders side by side on worker threads, in the order given.
+		static std::vector<Ref<Shader>> Create(const std::vector<std::string>& filepaths);
 	};
 
 	class ShaderLibrary
 	{
 	public:
+		struct ReloadRecord
+		{
+			std::string Name;
+			bool Succeeded;
+			float CompileMilliseconds;	// On the watcher thread.
+			float TotalMilliseconds;	// From noticing the change to the new program being in use.
+		};
+
+		ShaderLibrary();
+		~ShaderLibrary();
+		ShaderLibrary(ShaderLibrary&&) noexcept;
+		ShaderLibrary& operator=(ShaderLibrary&&) noexcept;
+
 		void Add(const Ref<Shader>& shader);
 		void Add(const std::string& name, const Ref<Shader>& shader);
 
@@ -39,7 +105,20 @@ namespace Sora {
 		Ref<Shader> Get(const std::string& name);
 
 		bool IsExist(const std::string& name) const;
+
+		// Watches the files of the shaders on a background thread, and recompiles them when they change. OnUpdate()
+		// must be called from the render thread to swap the recompiled programs in.
+		void SetHotReload(bool enabled);
+		bool IsHotReloadEnabled() const { return (bool)m_Watcher; }
+		void OnUpdate();
+
+		// Most recent last.
+		const std::deque<ReloadRecord>& GetReloadHistory() const { return m_ReloadHistory; }
 	private:
 		std::unordered_map<std::string, Ref<Shader>> m_Shaders;
+
+		struct Watcher;
+		Scope<Watcher> m_Watcher;
+		std::deque<ReloadRecord> m_ReloadHistory;
 	};
 }
@@ -30,4 +30,26 @@ namespace Sora{
 		return nullptr;
 	}
 
-}
\ No newline at end of file
+	Ref<Texture2D> Texture2D::CreateAsync(const std::string& path)
+	{
+		return Renderer::GetTextureStreamer().Load(path);
+	}
+
+	Ref<Texture2D> Texture2D::CreateThumbnailAsync(const std::string& path, uint32_t maxSize)
+	{
+		return Renderer::GetTextureStreamer().Load(path, maxSize);
+	}
+
+	Ref<Texture2DArray> Texture2DArray::Create(const Texture2D& prototype, uint32_t layerCount)
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:	SORA_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+		case RendererAPI::API::OpenGL:	return CreateRef<OpenGLTexture2DArray>(prototype, layerCount);
+		}
+
+		SORA_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+}
@@ -4,6 +4,7 @@
 #include <filesystem>
 
 #include "Sora/Core/Core.h"
+#include "Sora/Renderer/TextureImporter.h"
 
 namespace Sora {
 
@@ -16,6 +17,8 @@ namespace Sora {
 		virtual uint32_t GetHeight() const = 0;
 		virtual uint32_t GetRendererID() const = 0;
 		virtual const std::filesystem::path& GetTexturePath() const = 0;
+		// False while a streamed texture still holds its placeholder.
+		virtual bool IsLoaded() const = 0;
 
 		virtual void SetData(void* data, uint32_t size) = 0;
 
@@ -27,8 +30,41 @@ namespace Sora {
 	class Texture2D : public Texture
 	{
 	public:
+		virtual TextureFormat GetFormat() const = 0;
+		virtual uint32_t GetLevelCount() const = 0;
+		// Incremented by every SetData(), so that copies of the texture can tell they are out of date.
+		virtual uint32_t GetDataVersion() const = 0;
+		// True when every texel has full alpha, so sprites using it need no blending. False while still loading.
+		virtual bool IsOpaque() const = 0;
+
+		// GPU-side copy of all of 'source' to (x, y) in this texture. Returns false if the formats cannot be converted.
+		virtual bool CopyFrom(const Texture2D& source, uint32_t x, uint32_t y) = 0;
+		// The same for a rectangle of 'source', which may be this texture as long as the rectangles do not overlap.
+		virtual bool CopyFrom(const Texture2D& source, uint32_t sourceX, uint32_t sourceY, uint32_t width, uint32_t height, uint32_t x, uint32_t y) = 0;
+
 		static Ref<Texture2D> Create(uint32_t width, uint32_t height);
 		static Ref<Texture2D> Create(const std::string& path);
+		// Returns at once, the pixels follow a few frames later. See TextureStreamer.
+		static Ref<Texture2D> CreateAsync(const std::string& path);
+		// The same for a preview no larger than 'maxSize' on either side, e.g. for file browsers.
+		static Ref<Texture2D> CreateThumbnailAsync(const std::string& path, uint32_t maxSize);
+	};
+
+	// A stack of equally sized 2D layers sampled through a single binding.
+	class Texture2DArray : public Texture
+	{
+	public:
+		virtual uint32_t GetLayerCount() const = 0;
+
+		// True when 'texture' has the size and format of a layer.
+		virtual bool CanHold(const Texture2D& texture) const = 0;
+		// Moves the texture into the given layer: its pixels are copied there on the GPU, and the texture becomes a view
+		// of the layer. It keeps no storage of its own, later changes to it land in the layer, and its renderer ID
+		// changes.
+		virtual void SetLayer(uint32_t layer, Texture2D& texture) = 0;
+
+		// Layers take the size and format of 'prototype'.
+		static Ref<Texture2DArray> Create(const Texture2D& prototype, uint32_t layerCount);
 	};
 
 }
\ No newline at end of file
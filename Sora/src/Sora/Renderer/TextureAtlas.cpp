@@ -0,0 +1,331 @@
+#include "sorapch.h"
+#include "TextureAtlas.h"
+
+namespace Sora {
+
+	TextureAtlas::TextureAtlas(uint32_t pageSize, uint32_t maxTextureSize, uint32_t maxPages, uint32_t padding)
+		: m_PageSize(pageSize), m_MaxTextureSize(maxTextureSize), m_MaxPages(maxPages), m_Padding(padding)
+	{
+		SORA_CORE_ASSERT(maxTextureSize + padding * 2 <= pageSize, "Atlas pages are too small for the largest texture!");
+		SORA_CORE_ASSERT(maxPages > 0, "Atlas needs at least one page!");
+	}
+
+	Ref<SubTexture2D> TextureAtlas::Insert(const Ref<Texture2D>& texture)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		const uint32_t width = texture->GetWidth();
+		const uint32_t height = texture->GetHeight();
+		if (width > m_MaxTextureSize || height > m_MaxTextureSize || !texture->IsLoaded())
+			return nullptr;
+
+		// Pages have a single level, so a mipmapped texture would lose its mips there and alias when minified. Block
+		// compressed ones are smaller on their own than as RGBA8 texels in a page.
+		if (texture->GetLevelCount() > 1 || TextureImporter::IsCompressed(texture->GetFormat()))
+			return nullptr;
+
+		auto it = m_Entries.find(texture.get());
+		if (it != m_Entries.end())
+		{
+			Entry& entry = it->second;
+			if (entry.Source.lock() == texture)
+			{
+				if (entry.Region && entry.DataVersion != texture->GetDataVersion())
+				{
+					// Same size, same place: only the pixels changed.
+					CopyIntoPage(m_Pages[entry.PageIndex], *texture, entry.X, entry.Y);
+					entry.DataVersion = texture->GetDataVersion();
+				}
+				return entry.Region;
+			}
+
+			// The address belonged to a texture that has been destroyed since.
+			ReleaseExpired();
+		}
+
+		int32_t x, y;
+		int32_t pageIndex = FindPage(width + m_Padding * 2, height + m_Padding * 2, x, y);
+		if (pageIndex == -1)
+			return nullptr;
+
+		Page& page = m_Pages[pageIndex];
+		x += m_Padding;
+		y += m_Padding;
+
+		Entry entry;
+		entry.Source = texture;
+		entry.PageIndex = pageIndex;
+		entry.Pixels = (uint64_t)width * height;
+		entry.X = x;
+		entry.Y = y;
+		entry.DataVersion = texture->GetDataVersion();
+
+		// Formats the page cannot take are remembered with an empty region so they are not packed again.
+		if (CopyIntoPage(page, *texture, x, y))
+		{
+			glm::vec2 min = { (float)x / m_PageSize, (float)y / m_PageSize };
+			glm::vec2 max = { (float)(x + width) / m_PageSize, (float)(y + height) / m_PageSize };
+			entry.Region = CreateRef<SubTexture2D>(page.Texture, min, max);
+
+			page.TextureCount++;
+			page.UsedPixels += entry.Pixels;
+		}
+		else
+		{
+			SORA_CORE_WARN("Texture '{0}' has a format the texture atlas cannot hold", texture->GetTexturePath().string());
+		}
+
+		Ref<SubTexture2D> region = entry.Region;
+		m_Entries[texture.get()] = std::move(entry);
+		return region;
+	}
+
+	bool TextureAtlas::CopyIntoPage(Page& page, const Texture2D& texture, int32_t x, int32_t y)
+	{
+		if (!page.Texture->CopyFrom(texture, x, y))
+			return false;
+
+		// Columns first, then whole rows including the padding of the columns, which fills the corners as well.
+		const int32_t width = (int32_t)texture.GetWidth();
+		const int32_t height = (int32_t)texture.GetHeight();
+		const int32_t padding = (int32_t)m_Padding;
+		for (int32_t i = 1; i <= padding; i++)
+		{
+			page.Texture->CopyFrom(*page.Texture, x, y, 1, height, x - i, y);
+			page.Texture->CopyFrom(*page.Texture, x + width - 1, y, 1, height, x + width - 1 + i, y);
+		}
+		for (int32_t i = 1; i <= padding; i++)
+		{
+			page.Texture->CopyFrom(*page.Texture, x - padding, y, width + padding * 2, 1, x - padding, y - i);
+			page.Texture->CopyFrom(*page.Texture, x - padding, y + height - 1, width + padding * 2, 1, x - padding, y + height - 1 + i);
+		}
+		return true;
+	}
+
+	Ref<SubTexture2D> TextureAtlas::Find(const Ref<Texture2D>& texture) const
+	{
+		auto it = m_Entries.find(texture.get());
+		if (it == m_Entries.end() || it->second.Source.lock() != texture)
+			return nullptr;
+
+		return it->second.Region;
+	}
+
+	void TextureAtlas::EvictPage(uint32_t pageIndex)
+	{
+		SORA_CORE_ASSERT(pageIndex < m_Pages.size(), "Atlas page index out of range!");
+
+		RemoveEntriesOfPage(pageIndex);
+		m_Pages[pageIndex] = Page();
+		m_Generation++;
+	}
+
+	void TextureAtlas::ReleaseExpired()
+	{
+		bool released = false;
+		for (auto it = m_Entries.begin(); it != m_Entries.end();)
+		{
+			if (!it->second.Source.expired())
+			{
+				++it;
+				continue;
+			}
+
+			if (it->second.Region)
+			{
+				Page& page = m_Pages[it->second.PageIndex];
+				page.TextureCount--;
+				page.UsedPixels -= it->second.Pixels;
+				released = true;
+			}
+			it = m_Entries.erase(it);
+		}
+
+		for (uint32_t i = 0; i < (uint32_t)m_Pages.size(); i++)
+		{
+			if (m_Pages[i].Texture && m_Pages[i].TextureCount == 0)
+			{
+				EvictPage(i);
+				released = true;
+			}
+		}
+
+		if (released)
+			m_Generation++;
+	}
+
+	void TextureAtlas::Clear()
+	{
+		m_Entries.clear();
+		m_Pages.clear();
+		m_Generation++;
+	}
+
+	TextureAtlas::Statistics TextureAtlas::GetStats() const
+	{
+		Statistics stats;
+		for (const Page& page : m_Pages)
+		{
+			if (!page.Texture)
+				continue;
+
+			stats.PageCount++;
+			stats.TextureCount += page.TextureCount;
+			stats.UsedPixels += page.UsedPixels;
+			stats.PagePixels += (uint64_t)m_PageSize * m_PageSize;
+		}
+		return stats;
+	}
+
+	int32_t TextureAtlas::FindPage(uint32_t width, uint32_t height, int32_t& x, int32_t& y)
+	{
+		uint32_t livePages = 0;
+		for (size_t i = 0; i < m_Pages.size(); i++)
+		{
+			if (!m_Pages[i].Texture)
+				continue;
+
+			livePages++;
+			if (PackIntoPage(m_Pages[i], width, height, x, y))
+				return (int32_t)i;
+		}
+
+		int32_t pageIndex = -1;
+		if (livePages >= m_MaxPages)
+		{
+			// Every page is full: give up the one holding the fewest texels, its textures are packed again on demand.
+			uint64_t leastUsed = UINT64_MAX;
+			for (size_t i = 0; i < m_Pages.size(); i++)
+			{
+				if (m_Pages[i].Texture && m_Pages[i].UsedPixels < leastUsed)
+				{
+					leastUsed = m_Pages[i].UsedPixels;
+					pageIndex = (int32_t)i;
+				}
+			}
+			EvictPage(pageIndex);
+		}
+		else
+		{
+			for (size_t i = 0; i < m_Pages.size() && pageIndex == -1; i++)
+			{
+				if (!m_Pages[i].Texture)
+					pageIndex = (int32_t)i;
+			}
+
+			if (pageIndex == -1)
+			{
+				pageIndex = (int32_t)m_Pages.size();
+				m_Pages.emplace_back();
+			}
+		}
+
+		Page& page = m_Pages[pageIndex];
+		page.Texture = Texture2D::Create(m_PageSize, m_PageSize);
+		page.Skyline.push_back({ 0, 0, (int32_t)m_PageSize });
+
+		if (!PackIntoPage(page, width, height, x, y))
+			return -1;
+
+		return pageIndex;
+	}
+
+	int32_t TextureAtlas::FitSkyline(const Page& page, size_t nodeIndex, int32_t width, int32_t height) const
+	{
+		int32_t x = page.Skyline[nodeIndex].X;
+		if (x + width > (int32_t)m_PageSize)
+			return -1;
+
+		// The rectangle rests on the highest node it spans.
+		int32_t y = 0;
+		int32_t widthLeft = width;
+		for (size_t i = nodeIndex; widthLeft > 0; i++)
+		{
+			if (i == page.Skyline.size())
+				return -1;
+
+			y = std::max(y, page.Skyline[i].Y);
+			if (y + height > (int32_t)m_PageSize)
+				return -1;
+
+			widthLeft -= page.Skyline[i].Width;
+		}
+
+		return y;
+	}
+
+	bool TextureAtlas::PackIntoPage(Page& page, int32_t width, int32_t height, int32_t& x, int32_t& y)
+	{
+		// Bottom-left heuristic: lowest top edge first, narrowest node to break ties.
+		int32_t bestIndex = -1;
+		int32_t bestTop = INT32_MAX;
+		int32_t bestWidth = INT32_MAX;
+		for (size_t i = 0; i < page.Skyline.size(); i++)
+		{
+			int32_t fitY = FitSkyline(page, i, width, height);
+			if (fitY == -1)
+				continue;
+
+			int32_t top = fitY + height;
+			if (top < bestTop || (top == bestTop && page.Skyline[i].Width < bestWidth))
+			{
+				bestIndex = (int32_t)i;
+				bestTop = top;
+				bestWidth = page.Skyline[i].Width;
+				x = page.Skyline[i].X;
+				y = fitY;
+			}
+		}
+
+		if (bestIndex == -1)
+			return false;
+
+		page.Skyline.insert(page.Skyline.begin() + bestIndex, { x, y + height, width });
+
+		// Trim the nodes now covered by the new one.
+		for (size_t i = bestIndex + 1; i < page.Skyline.size();)
+		{
+			const SkylineNode& previous = page.Skyline[i - 1];
+			SkylineNode& node = page.Skyline[i];
+
+			int32_t overlap = previous.X + previous.Width - node.X;
+			if (overlap <= 0)
+				break;
+
+			node.X += overlap;
+			node.Width -= overlap;
+			if (node.Width > 0)
+				break;
+
+			page.Skyline.erase(page.Skyline.begin() + i);
+		}
+
+		// Merge neighbours at the same height.
+		for (size_t i = 0; i + 1 < page.Skyline.size();)
+		{
+			if (page.Skyline[i].Y == page.Skyline[i + 1].Y)
+			{
+				page.Skyline[i].Width += page.Skyline[i + 1].Width;
+				page.Skyline.erase(page.Skyline.begin() + i + 1);
+			}
+			else
+			{
+				i++;
+			}
+		}
+
+		return true;
+	}
+
+	void TextureAtlas::RemoveEntriesOfPage(uint32_t pageIndex)
+	{
+		for (auto it = m_Entries.begin(); it != m_Entries.end();)
+		{
+			if (it->second.Region && it->second.PageIndex == pageIndex)
+				it = m_Entries.erase(it);
+			else
+				++it;
+		}
+	}
+
+}
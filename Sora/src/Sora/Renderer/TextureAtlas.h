@@ -0,0 +1,86 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "Texture.h"
+#include "SubTexture2D.h"
+
+namespace Sora {
+
+	// Packs small textures into large pages with a skyline packer so that sprites using different textures can share
+	// a texture slot. Textures are copied on the GPU, and copied again after SetData() changed them; the source
+	// texture is only referenced weakly. The padding around each texture repeats its edge texels, so that filtering
+	// at the edge of a region never picks up its neighbours.
+	class TextureAtlas
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t PageCount = 0;
+			uint32_t TextureCount = 0;
+			uint64_t UsedPixels = 0;
+			uint64_t PagePixels = 0;
+
+			float GetPackingEfficiency() const { return PagePixels ? (float)((double)UsedPixels / (double)PagePixels) : 0.0f; }
+		};
+
+		TextureAtlas(uint32_t pageSize = 2048, uint32_t maxTextureSize = 256, uint32_t maxPages = 8, uint32_t padding = 1);
+
+		// Returns the region holding 'texture', packing it first if needed. Returns nullptr when the texture is too
+		// big, is still streaming in, has mips, has a format the pages cannot hold, or no room could be made.
+		Ref<SubTexture2D> Insert(const Ref<Texture2D>& texture);
+		Ref<SubTexture2D> Find(const Ref<Texture2D>& texture) const;
+
+		// Skyline pages cannot free single rectangles, so space is reclaimed one page at a time.
+		void EvictPage(uint32_t pageIndex);
+		// Drops textures that no longer exist and evicts pages left without any.
+		void ReleaseExpired();
+		void Clear();
+
+		// Incremented every time a region is dropped, so callers caching regions know to look them up again.
+		uint32_t GetGeneration() const { return m_Generation; }
+
+		Statistics GetStats() const;
+	private:
+		struct SkylineNode
+		{
+			int32_t X, Y, Width;
+		};
+
+		struct Page
+		{
+			Ref<Texture2D> Texture;
+			std::vector<SkylineNode> Skyline;
+			uint32_t TextureCount = 0;
+			uint64_t UsedPixels = 0;
+		};
+
+		struct Entry
+		{
+			std::weak_ptr<Texture2D> Source;
+			Ref<SubTexture2D> Region;
+			uint32_t PageIndex;
+			uint64_t Pixels;
+			int32_t X, Y;			// Of the texture inside the page, padding excluded.
+			uint32_t DataVersion;	// Of the source when it was copied.
+		};
+
+		int32_t FindPage(uint32_t width, uint32_t height, int32_t& x, int32_t& y);
+		bool CopyIntoPage(Page& page, const Texture2D& texture, int32_t x, int32_t y);
+		bool PackIntoPage(Page& page, int32_t width, int32_t height, int32_t& x, int32_t& y);
+		int32_t FitSkyline(const Page& page, size_t nodeIndex, int32_t width, int32_t height) const;
+		void RemoveEntriesOfPage(uint32_t pageIndex);
+	private:
+		uint32_t m_PageSize;
+		uint32_t m_MaxTextureSize;
+		uint32_t m_MaxPages;
+		uint32_t m_Padding;
+
+		std::vector<Page> m_Pages;	// Evicted pages keep their index with a null texture until reused.
+		// Keyed by the source texture, which may be destroyed and another one created at its address in the meantime.
+		std::unordered_map<const Texture2D*, Entry> m_Entries;
+
+		uint32_t m_Generation = 1;
+	};
+
+}
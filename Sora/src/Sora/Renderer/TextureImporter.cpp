@@ -0,0 +1,472 @@
+#include "sorapch.h"
+#include "TextureImporter.h"
+
+#include "BlockCompression.h"
+
+#include "stb_image.h"
+#include <fstream>
+
+namespace Sora {
+
+	namespace Utils {
+
+		static const char* GetTextureCacheDirectory()
+		{
+			return "assets/cache/texture";
+		}
+
+		static const char* CachedTextureFileExtension()
+		{
+			return ".sotex";
+		}
+
+		static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+		{
+			// FNV-1a
+			const uint8_t* bytes = (const uint8_t*)data;
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		// <stem>.<path hash>., shared by every texture file of one source. Sources with the same name in different
+		// directories differ in the path hash.
+		static std::string GetTextureCachePrefix(const std::string& path, const std::string& sourcePath)
+		{
+			char hex[17];
+			snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)HashBytes(sourcePath.data(), sourcePath.size()));
+			return std::filesystem::path(path).stem().string() + "." + hex + ".";
+		}
+
+		// Of what identifies the source, so that a cache hit reads nothing of it.
+		static bool HashSource(const std::string& path, std::string& o_SourcePath, uint64_t& o_Hash)
+		{
+			std::error_code error;
+			const uintmax_t sourceSize = std::filesystem::file_size(path, error);
+			if (error)
+				return false;
+			const auto sourceTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+			o_SourcePath = std::filesystem::absolute(path, error).lexically_normal().string();
+
+			o_Hash = HashBytes(&TextureFileHeader::CurrentVersion, sizeof(uint32_t));
+			o_Hash = HashBytes(o_SourcePath.data(), o_SourcePath.size(), o_Hash);
+			o_Hash = HashBytes(&sourceSize, sizeof(sourceSize), o_Hash);
+			o_Hash = HashBytes(&sourceTime, sizeof(sourceTime), o_Hash);
+			return true;
+		}
+
+		static std::filesystem::path GetTextureCachePath(const std::string& prefix, uint64_t hash)
+		{
+			char hex[17];
+			snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+			return std::filesystem::path(GetTextureCacheDirectory()) / (prefix + hex + CachedTextureFileExtension());
+		}
+
+		static uint32_t GetChannelCount(TextureFormat format)
+		{
+			switch (format)
+			{
+				case TextureFormat::R8:		return 1;
+				case TextureFormat::RG8:	return 2;
+				case TextureFormat::RGB8:	return 3;
+				default:					return 4;	// Compressed formats are encoded from RGBA.
+			}
+		}
+
+		static uint32_t GetBlockBytes(TextureFormat format)
+		{
+			switch (format)
+			{
+				case TextureFormat::BC1:	return BlockCompression::BC1BlockBytes;
+				case TextureFormat::BC3:	return BlockCompression::BC3BlockBytes;
+				case TextureFormat::BC7:	return BlockCompression::BC7BlockBytes;
+			}
+
+			SORA_CORE_ASSERT(false, "Not a compressed texture format!");
+			return 0;
+		}
+
+		static const char* TextureFormatToString(TextureFormat format)
+		{
+			switch (format)
+			{
+				case TextureFormat::R8:		return "R8";
+				case TextureFormat::RG8:	return "RG8";
+				case TextureFormat::RGB8:	return "RGB8";
+				case TextureFormat::RGBA8:	return "RGBA8";
+				case TextureFormat::BC1:	return "BC1";
+				case TextureFormat::BC3:	return "BC3";
+				case TextureFormat::BC7:	return "BC7";
+			}
+			return "None";
+		}
+
+		// 2x2 box filter. Odd sizes repeat their last row or column. With an alpha channel, colours are weighted by
+		// their alpha, so that the colour of fully transparent texels does not bleed into the edges of the visible ones.
+		static void Downsample(const uint8_t* source, uint32_t width, uint32_t height, uint32_t channels, uint8_t* destination)
+		{
+			const uint32_t destinationWidth = std::max(width / 2, 1u);
+			const uint32_t destinationHeight = std::max(height / 2, 1u);
+			for (uint32_t y = 0; y < destinationHeight; y++)
+			{
+				const uint8_t* row0 = source + (size_t)std::min(y * 2, height - 1) * width * channels;
+				const uint8_t* row1 = source + (size_t)std::min(y * 2 + 1, height - 1) * width * channels;
+				for (uint32_t x = 0; x < destinationWidth; x++)
+				{
+					const uint32_t x0 = std::min(x * 2, width - 1) * channels;
+					const uint32_t x1 = std::min(x * 2 + 1, width - 1) * channels;
+					const uint8_t* texels[4] = { row0 + x0, row0 + x1, row1 + x0, row1 + x1 };
+
+					const uint32_t alphaSum = channels == 4 ? texels[0][3] + texels[1][3] + texels[2][3] + texels[3][3] : 0;
+					if (alphaSum == 0)
+					{
+						for (uint32_t c = 0; c < channels; c++)
+							*destination++ = (uint8_t)((texels[0][c] + texels[1][c] + texels[2][c] + texels[3][c] + 2) / 4);
+						continue;
+					}
+
+					for (uint32_t c = 0; c < 3; c++)
+					{
+						const uint32_t weighted = texels[0][c] * texels[0][3] + texels[1][c] * texels[1][3] +
+							texels[2][c] * texels[2][3] + texels[3][c] * texels[3][3];
+						*destination++ = (uint8_t)((weighted + alphaSum / 2) / alphaSum);
+					}
+					*destination++ = (uint8_t)((alphaSum + 2) / 4);
+				}
+			}
+		}
+
+		static bool ReadFile(const std::string& path, std::vector<uint8_t>& o_Data)
+		{
+			std::ifstream in(path, std::ios::in | std::ios::binary | std::ios::ate);
+			if (!in)
+				return false;
+
+			o_Data.resize((size_t)in.tellg());
+			in.seekg(0, std::ios::beg);
+			in.read((char*)o_Data.data(), o_Data.size());
+			return true;
+		}
+
+		static bool IsOpaque(const std::vector<uint8_t>& pixels, uint32_t channels)
+		{
+			if (channels != 4)
+				return true;
+
+			for (size_t i = 3; i < pixels.size(); i += 4)
+			{
+				if (pixels[i] != 0xFF)
+					return false;
+			}
+			return true;
+		}
+
+		static bool MapTextureFile(const std::filesystem::path& filepath, TextureImage& image)
+		{
+			auto file = CreateRef<MappedFile>(filepath);
+			if (!file->IsValid() || file->GetSize() < sizeof(TextureFileHeader))
+				return false;
+
+			const uint8_t* data = file->GetData();
+			const size_t size = file->GetSize();
+
+			TextureFileHeader header;
+			memcpy(&header, data, sizeof(header));
+			if (header.Magic != TextureFileHeader::MagicValue || header.Version != TextureFileHeader::CurrentVersion ||
+				header.LevelCount == 0 || sizeof(header) + (size_t)header.LevelCount * sizeof(TextureFileLevel) > size)
+				return false;
+
+			image.Width = header.Width;
+			image.Height = header.Height;
+			image.Format = (TextureFormat)header.Format;
+			image.Opaque = header.Flags & TextureFileHeader::Opaque;
+			image.Levels.resize(header.LevelCount);
+			for (uint32_t i = 0; i < header.LevelCount; i++)
+			{
+				TextureFileLevel level;
+				memcpy(&level, data + sizeof(header) + i * sizeof(TextureFileLevel), sizeof(level));
+
+				// A file cut short by a crash while it was written.
+				if (level.Offset + level.Size > size)
+					return false;
+
+				image.Levels[i] = { level.Width, level.Height, (size_t)level.Offset, (size_t)level.Size };
+			}
+
+			image.Data.clear();
+			image.File = file;
+			return true;
+		}
+
+		static void WriteTextureFile(const std::filesystem::path& filepath, const std::string& prefix, const TextureImage& image)
+		{
+			std::error_code error;
+			std::filesystem::create_directories(GetTextureCacheDirectory(), error);
+
+			TextureFileHeader header = {};
+			header.Magic = TextureFileHeader::MagicValue;
+			header.Version = TextureFileHeader::CurrentVersion;
+			header.Width = image.Width;
+			header.Height = image.Height;
+			header.Format = (uint32_t)image.Format;
+			header.LevelCount = (uint32_t)image.Levels.size();
+			header.Flags = TextureFileHeader::FlippedVertically;
+			if (TextureImporter::IsCompressed(image.Format))
+				header.Flags |= TextureFileHeader::Compressed;
+			if (image.Opaque)
+				header.Flags |= TextureFileHeader::Opaque;
+
+			std::vector<TextureFileLevel> levels(image.Levels.size());
+			uint64_t offset = sizeof(header) + levels.size() * sizeof(TextureFileLevel);
+			for (size_t i = 0; i < levels.size(); i++)
+			{
+				offset = (offset + 15) & ~15ull;
+				levels[i] = { image.Levels[i].Width, image.Levels[i].Height, offset, image.Levels[i].Size };
+				offset += image.Levels[i].Size;
+			}
+
+			// Written next to its final name and moved in place, so that a concurrent import of the same file never
+			// maps half of it.
+			std::filesystem::path temporaryPath = filepath;
+			temporaryPath += ".tmp";
+			{
+				std::ofstream out(temporaryPath, std::ios::out | std::ios::binary);
+				if (!out)
+					return;
+
+				out.write((const char*)&header, sizeof(header));
+				out.write((const char*)levels.data(), levels.size() * sizeof(TextureFileLevel));
+				for (size_t i = 0; i < levels.size(); i++)
+				{
+					static const char padding[16] = {};
+					out.write(padding, levels[i].Offset - (uint64_t)out.tellp());
+					out.write((const char*)image.GetData() + image.Levels[i].Offset, image.Levels[i].Size);
+				}
+			}
+			std::filesystem::rename(temporaryPath, filepath, error);
+
+			// Files for earlier versions of the same source are never read again.
+			for (const auto& entry : std::filesystem::directory_iterator(GetTextureCacheDirectory(), error))
+			{
+				const std::string name = entry.path().filename().string();
+				if (entry.path() != filepath && name.starts_with(prefix) && name.ends_with(CachedTextureFileExtension()) &&
+					name.size() == prefix.size() + 16 + strlen(CachedTextureFileExtension()))
+					std::filesystem::remove(entry.path(), error);
+			}
+		}
+
+	}
+
+	TextureImporter::Settings& TextureImporter::GetSettings()
+	{
+		static Settings settings;
+		return settings;
+	}
+
+	TextureFormat TextureImporter::GetImportFormat(uint32_t channels)
+	{
+		const Settings& settings = GetSettings();
+		switch (channels)
+		{
+			// One and two channel images are masks and lookup tables more often than colours, left as they are.
+			case 1:		return TextureFormat::R8;
+			case 2:		return TextureFormat::RG8;
+			case 3:		return settings.Compress ? TextureFormat::BC1 : TextureFormat::RGB8;
+			default:	return settings.Compress ? settings.AlphaFormat : TextureFormat::RGBA8;
+		}
+	}
+
+	uint32_t TextureImporter::GetImportLevelCount(uint32_t width, uint32_t height)
+	{
+		if (!GetSettings().GenerateMips)
+			return 1;
+
+		uint32_t levels = 1;
+		while ((std::max(width, height) >> levels) > 0)
+			levels++;
+		return levels;
+	}
+
+	bool TextureImporter::IsCompressed(TextureFormat format)
+	{
+		return format == TextureFormat::BC1 || format == TextureFormat::BC3 || format == TextureFormat::BC7;
+	}
+
+	uint32_t TextureImporter::GetRowCount(TextureFormat format, uint32_t height)
+	{
+		return IsCompressed(format) ? (height + 3) / 4 : height;
+	}
+
+	uint32_t TextureImporter::GetRowBytes(TextureFormat format, uint32_t width)
+	{
+		if (IsCompressed(format))
+			return (width + 3) / 4 * Utils::GetBlockBytes(format);
+
+		return width * Utils::GetChannelCount(format);
+	}
+
+	bool TextureImporter::Import(const std::string& path, TextureImage& o_Image)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		std::string sourcePath;
+		uint64_t hash;
+		if (!Utils::HashSource(path, sourcePath, hash))
+			return false;
+
+		const Settings& settings = GetSettings();
+		hash = Utils::HashBytes(&settings.GenerateMips, sizeof(settings.GenerateMips), hash);
+		hash = Utils::HashBytes(&settings.Compress, sizeof(settings.Compress), hash);
+		hash = Utils::HashBytes(&settings.AlphaFormat, sizeof(settings.AlphaFormat), hash);
+
+		const std::string prefix = Utils::GetTextureCachePrefix(path, sourcePath);
+		std::filesystem::path filepath = Utils::GetTextureCachePath(prefix, hash);
+		if (Utils::MapTextureFile(filepath, o_Image))
+			return true;
+
+		std::vector<uint8_t> file;
+		if (!Utils::ReadFile(path, file))
+			return false;
+
+		int width, height, channels;
+		if (!stbi_info_from_memory(file.data(), (int)file.size(), &width, &height, &channels))
+			return false;
+
+		const TextureFormat format = GetImportFormat(channels);
+		const uint32_t levelCount = GetImportLevelCount(width, height);
+
+		const uint32_t decodeChannels = Utils::GetChannelCount(format);
+		stbi_set_flip_vertically_on_load_thread(1);
+		stbi_uc* pixels;
+		{
+			SORA_PROFILE_SCOPE("stbi_load_from_memory() - TextureImporter::Import");
+			pixels = stbi_load_from_memory(file.data(), (int)file.size(), &width, &height, &channels, (int)decodeChannels);
+		}
+		if (!pixels)
+			return false;
+
+		o_Image.Width = width;
+		o_Image.Height = height;
+		o_Image.Format = format;
+		o_Image.Levels.resize(levelCount);
+
+		size_t dataSize = 0;
+		for (uint32_t i = 0; i < levelCount; i++)
+		{
+			TextureImage::Level& level = o_Image.Levels[i];
+			level.Width = std::max((uint32_t)width >> i, 1u);
+			level.Height = std::max((uint32_t)height >> i, 1u);
+			level.Offset = dataSize;
+			level.Size = (size_t)GetRowCount(format, level.Height) * GetRowBytes(format, level.Width);
+			dataSize += level.Size;
+		}
+		o_Image.Data.resize(dataSize);
+		o_Image.File = nullptr;
+
+		// Each level is filtered from the one above it, uncompressed, so compression errors do not add up.
+		std::vector<uint8_t> current(pixels, pixels + (size_t)width * height * decodeChannels);
+		std::vector<uint8_t> next;
+		stbi_image_free(pixels);
+
+		o_Image.Opaque = Utils::IsOpaque(current, decodeChannels);
+
+		for (uint32_t i = 0; i < levelCount; i++)
+		{
+			const TextureImage::Level& level = o_Image.Levels[i];
+			uint8_t* destination = o_Image.Data.data() + level.Offset;
+			switch (format)
+			{
+				case TextureFormat::BC1: BlockCompression::CompressImage(current.data(), level.Width, level.Height, BlockCompression::BC1BlockBytes, BlockCompression::CompressBC1Block, destination); break;
+				case TextureFormat::BC3: BlockCompression::CompressImage(current.data(), level.Width, level.Height, BlockCompression::BC3BlockBytes, BlockCompression::CompressBC3Block, destination); break;
+				case TextureFormat::BC7: BlockCompression::CompressImage(current.data(), level.Width, level.Height, BlockCompression::BC7BlockBytes, BlockCompression::CompressBC7Block, destination); break;
+				default:				 memcpy(destination, current.data(), level.Size); break;
+			}
+
+			if (i + 1 < levelCount)
+			{
+				next.resize((size_t)std::max(level.Width / 2, 1u) * std::max(level.Height / 2, 1u) * decodeChannels);
+				Utils::Downsample(current.data(), level.Width, level.Height, decodeChannels, next.data());
+				std::swap(current, next);
+			}
+		}
+
+		SORA_CORE_INFO("Imported texture '{0}': {1}x{2} {3}, {4} levels, {5:.1f} KB ({6:.1f} KB as RGBA8 without mips)",
+			path, width, height, Utils::TextureFormatToString(format), levelCount, dataSize / 1024.0f, width * height * 4 / 1024.0f);
+
+		Utils::WriteTextureFile(filepath, prefix, o_Image);
+		return true;
+	}
+
+	void TextureImporter::GetThumbnailSize(uint32_t width, uint32_t height, uint32_t maxSize, uint32_t& o_Width, uint32_t& o_Height)
+	{
+		// The sizes Downsample() halves to.
+		o_Width = width;
+		o_Height = height;
+		while (std::max(o_Width, o_Height) > std::max(maxSize, 1u))
+		{
+			o_Width = std::max(o_Width / 2, 1u);
+			o_Height = std::max(o_Height / 2, 1u);
+		}
+	}
+
+	bool TextureImporter::ImportThumbnail(const std::string& path, uint32_t maxSize, TextureImage& o_Image)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		std::string sourcePath;
+		uint64_t hash;
+		if (!Utils::HashSource(path, sourcePath, hash))
+			return false;
+		hash = Utils::HashBytes(&maxSize, sizeof(maxSize), hash);
+
+		// A prefix of their own, so that thumbnails and full imports of the same source do not clean each other up.
+		const std::string prefix = Utils::GetTextureCachePrefix(path, sourcePath) + "thumbnail.";
+		std::filesystem::path filepath = Utils::GetTextureCachePath(prefix, hash);
+		if (Utils::MapTextureFile(filepath, o_Image))
+			return true;
+
+		std::vector<uint8_t> file;
+		if (!Utils::ReadFile(path, file))
+			return false;
+
+		int width, height, channels;
+		stbi_set_flip_vertically_on_load_thread(1);
+		stbi_uc* pixels;
+		{
+			SORA_PROFILE_SCOPE("stbi_load_from_memory() - TextureImporter::ImportThumbnail");
+			pixels = stbi_load_from_memory(file.data(), (int)file.size(), &width, &height, &channels, 4);
+		}
+		if (!pixels)
+			return false;
+
+		std::vector<uint8_t> current(pixels, pixels + (size_t)width * height * 4);
+		std::vector<uint8_t> next;
+		stbi_image_free(pixels);
+
+		uint32_t levelWidth = width;
+		uint32_t levelHeight = height;
+		while (std::max(levelWidth, levelHeight) > std::max(maxSize, 1u))
+		{
+			next.resize((size_t)std::max(levelWidth / 2, 1u) * std::max(levelHeight / 2, 1u) * 4);
+			Utils::Downsample(current.data(), levelWidth, levelHeight, 4, next.data());
+			std::swap(current, next);
+			levelWidth = std::max(levelWidth / 2, 1u);
+			levelHeight = std::max(levelHeight / 2, 1u);
+		}
+
+		o_Image.Width = levelWidth;
+		o_Image.Height = levelHeight;
+		o_Image.Format = TextureFormat::RGBA8;
+		o_Image.Levels = { { levelWidth, levelHeight, 0, current.size() } };
+		o_Image.Opaque = Utils::IsOpaque(current, 4);
+		o_Image.Data = std::move(current);
+		o_Image.File = nullptr;
+
+		Utils::WriteTextureFile(filepath, prefix, o_Image);
+		return true;
+	}
+
+}
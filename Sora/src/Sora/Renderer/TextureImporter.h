@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Sora/Core/Core.h"
+#include "Sora/Utils/PlatformUtils.h"
+
+namespace Sora {
+
+	enum class TextureFormat
+	{
+		None = 0,
+		R8, RG8, RGB8, RGBA8,
+		BC1, BC3, BC7
+	};
+
+	// Layout of the texture files the importer writes: this header, a TextureFileLevel per level, then the level
+	// data, each level starting on a 16 byte boundary. Levels are in the format the GPU takes, so a file is uploaded
+	// straight from a mapping of it.
+	struct TextureFileHeader
+	{
+		static constexpr uint32_t MagicValue = 0x58455453; // "STEX"
+		static constexpr uint32_t CurrentVersion = 4;
+
+		enum FlagBits : uint32_t
+		{
+			FlippedVertically	= 1 << 0,	// Rows are stored bottom first, the way OpenGL samples them.
+			Compressed			= 1 << 1,
+			Opaque				= 1 << 2	// Every texel has full alpha.
+		};
+
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t Width, Height;
+		uint32_t Format;	// TextureFormat
+		uint32_t LevelCount;
+		uint32_t Flags;
+		uint32_t Reserved;
+	};
+
+	struct TextureFileLevel
+	{
+		uint32_t Width, Height;
+		uint64_t Offset, Size;		// From the start of the file.
+	};
+
+	// The pixels of an image file the way the GPU takes them, with the whole mip chain. Rows are stored bottom first.
+	struct TextureImage
+	{
+		struct Level
+		{
+			uint32_t Width, Height;
+			size_t Offset, Size;	// From GetData().
+		};
+
+		uint32_t Width = 0, Height = 0;
+		TextureFormat Format = TextureFormat::None;
+		std::vector<Level> Levels;
+		bool Opaque = false;	// Every texel has full alpha.
+
+		// A freshly imported image owns its pixels. One read back from a texture file points into a mapping of it.
+		std::vector<uint8_t> Data;
+		Ref<MappedFile> File;
+
+		const uint8_t* GetData() const { return File ? File->GetData() : Data.data(); }
+	};
+
+	// Decodes image files, builds their mip chains and block-compresses them. Results are written to texture files,
+	// keyed by the path, size and modification time of the source and by the settings. Later loads map the texture
+	// file and never read the source at all.
+	class TextureImporter
+	{
+	public:
+		struct Settings
+		{
+			bool GenerateMips = true;
+			bool Compress = true;
+			// For images with an alpha channel, BC3 or BC7. Images without one use BC1.
+			TextureFormat AlphaFormat = TextureFormat::BC7;
+		};
+
+		// Read by worker threads, so change them before loading textures.
+		static Settings& GetSettings();
+
+		// What a file with 'channels' channels is imported as. Known from the header alone, before the file is decoded.
+		static TextureFormat GetImportFormat(uint32_t channels);
+		static uint32_t GetImportLevelCount(uint32_t width, uint32_t height);
+
+		// May be called from any thread. Returns false when the file cannot be read or decoded.
+		static bool Import(const std::string& path, TextureImage& o_Image);
+		// A single RGBA8 level, the image halved until neither side is larger than 'maxSize'. Cached like Import(),
+		// but neither compressed nor mipmapped, so previews of big images come cheap.
+		static bool ImportThumbnail(const std::string& path, uint32_t maxSize, TextureImage& o_Image);
+		static void GetThumbnailSize(uint32_t width, uint32_t height, uint32_t maxSize, uint32_t& o_Width, uint32_t& o_Height);
+
+		static bool IsCompressed(TextureFormat format);
+		// Rows the way uploads see them: pixel rows, or rows of 4x4 blocks for compressed formats.
+		static uint32_t GetRowCount(TextureFormat format, uint32_t height);
+		static uint32_t GetRowBytes(TextureFormat format, uint32_t width);
+	};
+
+}
@@ -0,0 +1,21 @@
+#include "sorapch.h"
+#include "TextureStreamer.h"
+
+#include "Renderer.h"
+#include "Platform/OpenGL/OpenGLTextureStreamer.h"
+
+namespace Sora {
+
+	Scope<TextureStreamer> TextureStreamer::Create()
+	{
+		switch (Renderer::GetAPI())
+		{
+		case RendererAPI::API::None:	SORA_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+		case RendererAPI::API::OpenGL:	return CreateScope<OpenGLTextureStreamer>();
+		}
+
+		SORA_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Sora/Renderer/Texture.h"
+
+namespace Sora {
+
+	// Loads image files without blocking the render thread. Files are decoded on worker threads, and their pixels are
+	// uploaded at most GetUploadBudget() bytes per frame. Until then the texture holds a placeholder colour.
+	class TextureStreamer
+	{
+	public:
+		struct Statistics
+		{
+			uint32_t PendingDecodes = 0;
+			uint32_t PendingUploads = 0;
+			uint32_t UploadedBytes = 0;		// During the last OnUpdate().
+			uint32_t LoadedCount = 0;		// Since the streamer was created.
+		};
+
+		virtual ~TextureStreamer() = default;
+
+		// Only reads the image header before returning. Call it on the render thread, which owns the GL context.
+		// Returns nullptr when the file cannot be read. With a 'thumbnailSize', loads the small single level of
+		// TextureImporter::ImportThumbnail() instead of the whole image.
+		virtual Ref<Texture2D> Load(const std::string& path, uint32_t thumbnailSize = 0) = 0;
+
+		// Uploads decoded images within the budget. Called once per frame on the render thread.
+		virtual void OnUpdate() = 0;
+
+		virtual void SetUploadBudget(uint32_t bytes) = 0;
+		virtual uint32_t GetUploadBudget() const = 0;
+
+		virtual Statistics GetStats() const = 0;
+
+		static Scope<TextureStreamer> Create();
+	};
+
+}
@@ -14,6 +14,8 @@ namespace Sora {
 		virtual void Unbind() const = 0;
 
 		virtual void AddVertexBuffer (const Ref<VertexBuffer>& vertexBuffer) = 0;
+		// Attributes of an instance buffer advance once per instance instead of once per vertex.
+		virtual void AddInstanceBuffer(const Ref<VertexBuffer>& instanceBuffer) = 0;
 		virtual void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) = 0;
 
 		virtual const std::vector<Ref<VertexBuffer>>& GetVertexBuffer() const = 0;
@@ -51,11 +51,42 @@ namespace Sora {
 		}
 	};
 
+	// Parent/child links, by UUID so that they survive copies and serialization. Every entity has one, roots have no
+	// Parent. Edited through Scene::SetParent(), which keeps both sides consistent.
+	struct RelationshipComponent
+	{
+		UUID Parent = 0;
+		std::vector<UUID> Children;
+
+		RelationshipComponent() = default;
+		RelationshipComponent(const RelationshipComponent&) = default;
+	};
+
+	// The world matrix of an entity, cached by Scene::UpdateWorldTransforms(). Added along with the TransformComponent
+	// and derived from it, so it is neither serialized nor shown in the editor.
+	struct WorldTransformComponent
+	{
+		glm::mat4 Transform = glm::mat4(1.0f);
+		glm::mat4 LocalTransform = glm::mat4(1.0f);	// Reused when only the parent moved.
+
+		// The local transform Transform was built from. Transforms are edited in place everywhere (panels, gizmos,
+		// physics, scripts), so changes are found by comparing against it, not through setters.
+		glm::vec3 Translation = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 Rotation = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 Scale = { 1.0f, 1.0f, 1.0f };
+		bool Dirty = true;
+
+		WorldTransformComponent() = default;
+		WorldTransformComponent(const WorldTransformComponent&) = default;
+	};
+
 	struct SpriteRendererComponent
 	{
 		glm::vec4 Color{ 1.0f, 1.0f, 1.0f, 1.0f };
 		Ref<Texture2D> Texture;
 		float TilingFactor = 1.0f;
+		int Layer = 0;	// Lower layers are drawn first, in [-128, 127].
+		bool Static = false;	// Opaque static sprites are kept in a retained GPU batch, rebuilt only when they change.
 
 		SpriteRendererComponent() = default;
 		SpriteRendererComponent(const SpriteRendererComponent&) = default;
@@ -68,6 +99,7 @@ namespace Sora {
 		glm::vec4 Color{ 1.0f, 1.0f, 1.0f, 1.0f };
 		float Thickness = 1.0f;
 		float Fade = 0.005f;
+		int Layer = 0;
 
 		CircleRendererComponent() = default;
 		CircleRendererComponent(const CircleRendererComponent&) = default;
@@ -149,5 +181,5 @@ namespace Sora {
 }
 // When adding a new component, remember to update the following files:
 // 1. 'SceneSerializer.cpp': Add Serialize and Deserialize methods for the component
-// 2. 'Scene.cpp': Implement OnComponentAdded, Util::CopyComponentIfExist, Util::CopyComponent function for the new component
+// 2. 'Scene.cpp': Implement OnComponentAdded, Utils::CopyComponentIfExist, and add it to the Utils::CopyStorages call in Scene::Copy
 // 3. 'SceneHierarchyPanel.cpp': Create UI elements for the component
\ No newline at end of file
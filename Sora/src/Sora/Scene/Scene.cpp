@@ -6,10 +6,15 @@
 #include "Sora/Scene/Entity.h"
 #include "Sora/Scene/Component.h"
 #include "Sora/Scene/ScriptableEntity.h"
+#include "Sora/Core/JobSystem.h"
 #include "Sora/Renderer/Renderer2D.h"
+#include "Sora/Math/Math.h"
 
 namespace Sora {
 
+	// Depths are swept in chunks of this many entities, on the job system. Smaller ones stay on the calling thread.
+	static const size_t s_TransformGrainSize = 1024;
+
 	namespace Utils{
 		
 		static b2BodyType TypeConvert(Rigidbody2DComponent::BodyType bodyType)
@@ -25,18 +30,43 @@ namespace Sora {
 			return b2_staticBody;
 		}
 
+		// The same entity handles, alive or released, with the same versions, so that components copy across as they are.
+		static void CopyEntities(entt::registry& dst, const entt::registry& src)
+		{
+			const auto& srcEntities = *src.storage<entt::entity>();
+			auto& dstEntities = dst.storage<entt::entity>();
+
+			dstEntities.reserve(srcEntities.size());
+			for (size_t i = 0; i < srcEntities.size(); i++)
+				dstEntities.emplace(srcEntities.data()[i]);
+			dstEntities.free_list(srcEntities.free_list());
+		}
+
+		// A whole pool, packed in the same order, so that draw order and sorted pools carry over.
 		template<typename Component>
-		static void CopyComponent(entt::registry& dst, entt::registry& src, const std::unordered_map<UUID, entt::entity>& enttMap)
+		static void CopyStorage(entt::registry& dst, const entt::registry& src)
 		{
-			auto view = src.view<Component>();
-			for (auto e : view)
-			{
-				UUID uuid = src.get<IDComponent>(e).ID;
-				entt::entity dstHandle = enttMap.at(uuid);
+			const auto* srcStorage = src.storage<Component>();
+			if (!srcStorage)
+				return;
 
-				auto& srcComponent = src.get<Component>(e);
-				dst.emplace_or_replace<Component>(dstHandle, srcComponent);
-			}
+			auto& dstStorage = dst.storage<Component>();
+			dstStorage.reserve(srcStorage->size());
+
+			const entt::sparse_set& entities = *srcStorage;
+			dstStorage.insert(entities.rbegin(), entities.rend(), srcStorage->crbegin());
+		}
+
+		template<typename... Component>
+		static void CopyStorages(entt::registry& dst, const entt::registry& src)
+		{
+			// Creating a storage changes the registry, filling one only touches the storage. So the storages are
+			// created first, then filled one job each.
+			(dst.storage<Component>(), ...);
+
+			JobCounter counter;
+			(JobSystem::Run([&dst, &src]() { CopyStorage<Component>(dst, src); }, &counter), ...);
+			JobSystem::Wait(counter);
 		}
 
 		template<typename Component>
@@ -50,6 +80,12 @@ namespace Sora {
 	Scene::Scene()
 	{
 		m_EditorCamera = EditorCamera(30.0f, 16.0f/9.0f, 0.1f, 1000.0f);
+
+		// Scripts may do anything to the scene, and poll input, which only the main thread can.
+		m_Systems.AddSystem("Scripts", SystemAccess().SetExclusive().SetMainThread(),
+			[](Scene& scene, Timestep ts) { scene.UpdateScripts(ts); });
+		m_Systems.AddSystem("Physics", SystemAccess().Read<Rigidbody2DComponent, RelationshipComponent>().Write<TransformComponent>(),
+			[](Scene& scene, Timestep ts) { scene.OnUpdatePhysics(ts); });
 	}
 
 	Scene::~Scene()
@@ -63,29 +99,21 @@ namespace Sora {
 		if (!other)
 			return newScene;
 
+		SORA_PROFILE_FUNCTION();
+
 		newScene->m_ViewportWidth = other->m_ViewportWidth;
 		newScene->m_ViewportHeight = other->m_ViewportHeight;
-		
-		std::unordered_map<UUID, entt::entity> enttMap;	
+
+		// Entities keep their handles, so the pools are copied whole and the UUID map as it is, with no lookups.
 		auto& srcRegistry = other->m_Registry;
 		auto& dstRegistry = newScene->m_Registry;
-		auto view = srcRegistry.view<IDComponent>();
-		for (auto e : view)
-		{
-			UUID uuid = srcRegistry.get<IDComponent>(e).ID;
-			const std::string& name = srcRegistry.get<TagComponent>(e).Tag;
-			Entity entity = newScene->CreateEntity(name, uuid);
-			enttMap[uuid] = entity;
-		}
+		Utils::CopyEntities(dstRegistry, srcRegistry);
+		Utils::CopyStorages<IDComponent, TagComponent, TransformComponent, RelationshipComponent, WorldTransformComponent,
+			SpriteRendererComponent, CircleRendererComponent, CameraComponent, NativeScriptComponent,
+			Rigidbody2DComponent, BoxCollider2DComponent, CircleCollider2DComponent>(dstRegistry, srcRegistry);
 
-		Utils::CopyComponent<TransformComponent>(dstRegistry, srcRegistry, enttMap);
-		Utils::CopyComponent<SpriteRendererComponent>(dstRegistry, srcRegistry, enttMap);
-		Utils::CopyComponent<CircleRendererComponent>(dstRegistry, srcRegistry, enttMap);
-		Utils::CopyComponent<CameraComponent>(dstRegistry, srcRegistry, enttMap);
-		Utils::CopyComponent<NativeScriptComponent>(dstRegistry, srcRegistry, enttMap);
-		Utils::CopyComponent<Rigidbody2DComponent>(dstRegistry, srcRegistry, enttMap);
-		Utils::CopyComponent<BoxCollider2DComponent>(dstRegistry, srcRegistry, enttMap);
-		Utils::CopyComponent<CircleCollider2DComponent>(dstRegistry, srcRegistry, enttMap);
+		newScene->m_EntityMap = other->m_EntityMap;
+		newScene->m_Systems = other->m_Systems;
 
 		//newScene->mWorldID = other->mWorldID;
 		return newScene;
@@ -96,18 +124,37 @@ namespace Sora {
 		Entity entity = { m_Registry.create(), this };
 		entity.AddComponent<IDComponent>(uuid.value_or(UUID()));
 		entity.AddComponent<TransformComponent>();
+		entity.AddComponent<RelationshipComponent>();
 		auto& tag = entity.AddComponent<TagComponent>();
 		tag.Tag = name.empty() ? "Untitled Entity" : name;
 
+		m_EntityMap[entity.GetUUID()] = entity;
+		m_HierarchyDirty = true;
 		return entity;
 	}
 
 	void Scene::DestroyEntity(Entity entity)
 	{
+		// Children go with their parent. Copied, since destroying them edits the list.
+		std::vector<UUID> children = entity.GetComponent<RelationshipComponent>().Children;
+		for (UUID child : children)
+			DestroyEntity(GetEntityByUUID(child));
+
+		if (Entity parent = GetParent(entity))
+			std::erase(parent.GetComponent<RelationshipComponent>().Children, entity.GetUUID());
+
+		m_EntityMap.erase(entity.GetUUID());
 		m_Registry.destroy(entity);
+		m_HierarchyDirty = true;
 	}
 
 	Entity Scene::DuplicateEntity(Entity entity)
+	{
+		// A sibling of the original, its local transform is relative to the same parent.
+		return DuplicateEntity(entity, GetParent(entity));
+	}
+
+	Entity Scene::DuplicateEntity(Entity entity, Entity parent)
 	{
 		std::string name = entity.GetName();
 		Entity newEntity = CreateEntity(name);
@@ -121,20 +168,76 @@ namespace Sora {
 		Utils::CopyComponentIfExist<BoxCollider2DComponent>(newEntity, entity);
 		Utils::CopyComponentIfExist<CircleCollider2DComponent>(newEntity, entity);
 
+		if (parent)
+			SetParent(newEntity, parent, false);
+
+		// Copied, since creating entities may move the component.
+		std::vector<UUID> children = entity.GetComponent<RelationshipComponent>().Children;
+		for (UUID child : children)
+			DuplicateEntity(GetEntityByUUID(child), newEntity);
+
 		return newEntity;
 	}
 
+	Entity Scene::GetEntityByUUID(UUID uuid)
+	{
+		auto it = m_EntityMap.find(uuid);
+		return it != m_EntityMap.end() ? Entity(it->second, this) : Entity();
+	}
+
+	Entity Scene::GetParent(Entity entity)
+	{
+		UUID parent = entity.GetComponent<RelationshipComponent>().Parent;
+		return parent ? GetEntityByUUID(parent) : Entity();
+	}
+
+	bool Scene::SetParent(Entity child, Entity parent, bool keepWorldTransform)
+	{
+		for (Entity ancestor = parent; ancestor; ancestor = GetParent(ancestor))
+		{
+			if (ancestor == child)
+				return false;
+		}
+
+		if (keepWorldTransform)
+		{
+			UpdateWorldTransforms();
+
+			glm::mat4 transform = child.GetComponent<WorldTransformComponent>().Transform;
+			if (parent)
+				transform = glm::inverse(parent.GetComponent<WorldTransformComponent>().Transform) * transform;
+
+			auto& component = child.GetComponent<TransformComponent>();
+			Math::DecomposeTransform(transform, component.Translation, component.Rotation, component.Scale);
+		}
+
+		auto& relationship = child.GetComponent<RelationshipComponent>();
+		if (Entity previous = GetParent(child))
+			std::erase(previous.GetComponent<RelationshipComponent>().Children, child.GetUUID());
+
+		relationship.Parent = parent ? parent.GetUUID() : UUID(0);
+		if (parent)
+			parent.GetComponent<RelationshipComponent>().Children.push_back(child.GetUUID());
+
+		m_HierarchyDirty = true;
+		return true;
+	}
+
 	void Scene::OnRuntimeStart()
 	{
 		b2WorldDef worldDef = b2DefaultWorldDef();
 		worldDef.gravity = { 0.0f, -9.8f };
 		m_WorldID = b2CreateWorld(&worldDef);
 
+		// Bodies live in world space, children of other entities included.
+		UpdateWorldTransforms();
+
 		auto viewRigidbody2D = m_Registry.view<Rigidbody2DComponent>();
 		for (auto e : viewRigidbody2D)
 		{
 			Entity entity = { e, this };
-			auto& transform = entity.GetComponent<TransformComponent>();
+			TransformComponent transform;
+			Math::DecomposeTransform(entity.GetComponent<WorldTransformComponent>().Transform, transform.Translation, transform.Rotation, transform.Scale);
 			auto& rb2d = entity.GetComponent<Rigidbody2DComponent>();
 
 			b2BodyDef bodyDef = b2DefaultBodyDef();
@@ -193,8 +296,20 @@ namespace Sora {
 		const int32_t subStepCount = 4;
 		b2World_Step(m_WorldID, ts, subStepCount);
 
+		// Shallower bodies first, so that a body under another body is placed relative to where that one is now. Sorted
+		// here rather than taken from m_TransformNodes, which only the main thread may rebuild.
+		std::vector<std::pair<uint32_t, entt::entity>> bodies;
 		auto viewRigidbody2D = m_Registry.view<Rigidbody2DComponent>();
 		for (auto e : viewRigidbody2D)
+		{
+			uint32_t depth = 0;
+			for (Entity parent = GetParent({ e, this }); parent; parent = GetParent(parent))
+				depth++;
+			bodies.push_back({ depth, e });
+		}
+		std::sort(bodies.begin(), bodies.end());
+
+		for (auto [depth, e] : bodies)
 		{
 			Entity entity = { e, this };
 			auto& transform = entity.GetComponent<TransformComponent>();
@@ -205,36 +320,176 @@ namespace Sora {
 			memcpy(&bodyID, &rb2d.RuntimeBody, sizeof(b2BodyId));
 
 			b2Vec2 position = b2Body_GetPosition(bodyID);
-			transform.Translation.x = position.x;
-			transform.Translation.y = position.y;
-
 			b2Rot rotation = b2Body_GetRotation(bodyID);
-			transform.Rotation.z = b2Rot_GetAngle(rotation);
+
+			if (depth == 0)
+			{
+				transform.Translation.x = position.x;
+				transform.Translation.y = position.y;
+				transform.Rotation.z = b2Rot_GetAngle(rotation);
+				continue;
+			}
+
+			// The body moved in world space, the local transform is what puts it there under its parent.
+			const glm::mat4 parentTransform = GetParentWorldTransform(entity);
+			TransformComponent world;
+			Math::DecomposeTransform(parentTransform * transform.GetTransform(), world.Translation, world.Rotation, world.Scale);
+			world.Translation.x = position.x;
+			world.Translation.y = position.y;
+			world.Rotation.z = b2Rot_GetAngle(rotation);
+
+			Math::DecomposeTransform(glm::inverse(parentTransform) * world.GetTransform(), transform.Translation, transform.Rotation, transform.Scale);
 		}
 	}
 
+	glm::mat4 Scene::GetParentWorldTransform(Entity entity)
+	{
+		// From the local transforms as they are now, rather than the cached world matrices of the last sweep.
+		glm::mat4 transform = glm::mat4(1.0f);
+		for (Entity parent = GetParent(entity); parent; parent = GetParent(parent))
+			transform = parent.GetComponent<TransformComponent>().GetTransform() * transform;
+		return transform;
+	}
+
+	void Scene::RebuildTransformHierarchy()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		m_TransformNodes.clear();
+		m_TransformLevels.clear();
+
+		// Links to entities that no longer exist are dropped, an entity whose parent is gone becomes a root.
+		auto view = m_Registry.view<RelationshipComponent>();
+		for (auto entity : view)
+		{
+			auto& relationship = view.get<RelationshipComponent>(entity);
+			if (relationship.Parent && !m_EntityMap.contains(relationship.Parent))
+				relationship.Parent = 0;
+
+			if (!relationship.Parent)
+				m_TransformNodes.push_back({ entity, UINT32_MAX });
+		}
+
+		for (uint32_t levelBegin = 0; levelBegin < m_TransformNodes.size(); )
+		{
+			m_TransformLevels.push_back(levelBegin);
+
+			const uint32_t levelEnd = (uint32_t)m_TransformNodes.size();
+			for (uint32_t i = levelBegin; i < levelEnd; i++)
+			{
+				std::erase_if(m_Registry.get<RelationshipComponent>(m_TransformNodes[i].Entity).Children, [this, i](UUID child)
+					{
+						auto it = m_EntityMap.find(child);
+						if (it == m_EntityMap.end())
+						{
+							SORA_CORE_WARN("Dropping the link to missing child entity {0}", (uint64_t)child);
+							return true;
+						}
+
+						m_TransformNodes.push_back({ it->second, i });
+						return false;
+					});
+			}
+			levelBegin = levelEnd;
+		}
+		m_TransformLevels.push_back((uint32_t)m_TransformNodes.size());
+
+		// m_WorldMatrices is only valid for the nodes it was swept for.
+		m_WorldMatrices.resize(m_TransformNodes.size());
+		m_WorldChanged.resize(m_TransformNodes.size());
+		for (const TransformNode& node : m_TransformNodes)
+			m_Registry.get<WorldTransformComponent>(node.Entity).Dirty = true;
+
+		m_HierarchyDirty = false;
+	}
+
+	void Scene::UpdateWorldTransforms()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		if (m_HierarchyDirty)
+			RebuildTransformHierarchy();
+
+		// Storages are looked up once, so that the sweep only reads the registry.
+		auto& transforms = m_Registry.storage<TransformComponent>();
+		auto& worlds = m_Registry.storage<WorldTransformComponent>();
+
+		auto update = [&](size_t index)
+		{
+			const TransformNode& node = m_TransformNodes[index];
+			const auto& transform = transforms.get(node.Entity);
+			auto& world = worlds.get(node.Entity);
+
+			const bool localChanged = world.Dirty || world.Translation != transform.Translation ||
+				world.Rotation != transform.Rotation || world.Scale != transform.Scale;
+			const bool parentChanged = node.Parent != UINT32_MAX && m_WorldChanged[node.Parent];
+
+			m_WorldChanged[index] = localChanged || parentChanged;
+			if (!m_WorldChanged[index])
+				return;
+
+			if (localChanged)
+			{
+				world.LocalTransform = transform.GetTransform();
+				world.Translation = transform.Translation;
+				world.Rotation = transform.Rotation;
+				world.Scale = transform.Scale;
+				world.Dirty = false;
+			}
+
+			world.Transform = node.Parent == UINT32_MAX ? world.LocalTransform : m_WorldMatrices[node.Parent] * world.LocalTransform;
+			m_WorldMatrices[index] = world.Transform;
+		};
+
+		// A depth only reads the one above it, so the entities within one are independent.
+		for (size_t level = 0; level + 1 < m_TransformLevels.size(); level++)
+		{
+			const size_t levelBegin = m_TransformLevels[level];
+			JobSystem::ParallelFor(m_TransformLevels[level + 1] - levelBegin, s_TransformGrainSize, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+						update(levelBegin + i);
+				});
+		}
+
+		m_TransformStats.RecomputedCount = (uint32_t)std::count(m_WorldChanged.begin(), m_WorldChanged.end(), 1);
+		m_TransformStats.ReusedCount = (uint32_t)m_TransformNodes.size() - m_TransformStats.RecomputedCount;
+	}
+
 	void Scene::OnUpdateEditor(Timestep ts, EditorCamera& camera)
 	{
+		UpdateWorldTransforms();
+
 		Renderer2D::BeginScene(camera);
 
-		auto groupTransformSprite = m_Registry.group<TransformComponent, SpriteRendererComponent>();
+		auto groupTransformSprite = m_Registry.group<WorldTransformComponent, SpriteRendererComponent>();
 		for (auto entity : groupTransformSprite)
 		{
-			auto [transform, sprite] = groupTransformSprite.get<TransformComponent, SpriteRendererComponent>(entity);
-			Renderer2D::DrawSprite(transform.GetTransform(), sprite, (int)entity);
+			auto [transform, sprite] = groupTransformSprite.get<WorldTransformComponent, SpriteRendererComponent>(entity);
+			Renderer2D::SubmitSprite(transform.Transform, sprite, (int)entity);
 		}
 
-		auto viewTransformCircle = m_Registry.view<TransformComponent, CircleRendererComponent>();
+		auto viewTransformCircle = m_Registry.view<WorldTransformComponent, CircleRendererComponent>();
 		for (auto entity : viewTransformCircle)
 		{
-			auto [transform, circle] = viewTransformCircle.get<TransformComponent, CircleRendererComponent>(entity);
-			Renderer2D::DrawCircle(transform.GetTransform(), circle, (int)entity);
+			auto [transform, circle] = viewTransformCircle.get<WorldTransformComponent, CircleRendererComponent>(entity);
+			Renderer2D::SubmitCircle(transform.Transform, circle, (int)entity);
 		}
 
 		Renderer2D::EndScene();
 	}
 
-	void Scene::OnUpdateRuntime(Timestep ts)
+	void Scene::RegisterSystem(const std::string& name, const SystemAccess& access, const SystemScheduler::SystemFunction& function)
+	{
+		m_Systems.AddSystem(name, access, function);
+	}
+
+	void Scene::UnregisterSystem(const std::string& name)
+	{
+		m_Systems.RemoveSystem(name);
+	}
+
+	void Scene::UpdateScripts(Timestep ts)
 	{
 		auto viewNativeScript = m_Registry.view<NativeScriptComponent>();
 		for (auto entity : viewNativeScript)
@@ -249,29 +504,35 @@ namespace Sora {
 
 			script.Instance->OnUpdate(ts);
 		}
+	}
 
-		OnUpdatePhysics(ts);
+	void Scene::OnUpdateRuntime(Timestep ts)
+	{
+		m_Systems.Run(*this, m_Registry, ts);
+
+		// After the systems, which move entities.
+		UpdateWorldTransforms();
 
 		Entity mainCamera = GetPrimaryCameraEntity();
 
 		if (mainCamera)
 		{
 			auto& mainCameraCamera = mainCamera.GetComponent<CameraComponent>().Camera;
-			auto mainCameraTransform = mainCamera.GetComponent<TransformComponent>().GetTransform();
+			const auto& mainCameraTransform = mainCamera.GetComponent<WorldTransformComponent>().Transform;
 			Renderer2D::BeginScene(mainCameraCamera, mainCameraTransform);
 
-			auto groupTransformSprite = m_Registry.group<TransformComponent, SpriteRendererComponent>();
+			auto groupTransformSprite = m_Registry.group<WorldTransformComponent, SpriteRendererComponent>();
 			for (auto entity : groupTransformSprite)
 			{
-				auto [transform, sprite] = groupTransformSprite.get<TransformComponent, SpriteRendererComponent>(entity);
-				Renderer2D::DrawSprite(transform.GetTransform(), sprite, (int)entity);
+				auto [transform, sprite] = groupTransformSprite.get<WorldTransformComponent, SpriteRendererComponent>(entity);
+				Renderer2D::SubmitSprite(transform.Transform, sprite, (int)entity);
 			}
 
-			auto viewTransformCircle = m_Registry.view<TransformComponent, CircleRendererComponent>();
+			auto viewTransformCircle = m_Registry.view<WorldTransformComponent, CircleRendererComponent>();
 			for (auto entity : viewTransformCircle)
 			{
-				auto [transform, circle] = viewTransformCircle.get<TransformComponent, CircleRendererComponent>(entity);
-				Renderer2D::DrawCircle(transform.GetTransform(), circle, (int)entity);
+				auto [transform, circle] = viewTransformCircle.get<WorldTransformComponent, CircleRendererComponent>(entity);
+				Renderer2D::SubmitCircle(transform.Transform, circle, (int)entity);
 			}
 
 			Renderer2D::EndScene();
@@ -325,6 +586,12 @@ namespace Sora {
 
 	template<>
 	void Scene::OnComponentAdded<TransformComponent>(Entity entity, TransformComponent& component)
+	{
+		m_Registry.emplace_or_replace<WorldTransformComponent>(entity);
+	}
+
+	template<>
+	void Scene::OnComponentAdded<RelationshipComponent>(Entity entity, RelationshipComponent& component)
 	{
 	}
 
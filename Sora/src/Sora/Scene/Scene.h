@@ -6,6 +6,7 @@
 #include "Sora/Core/Timestep.h"
 #include "Sora/Core/UUID.h"
 #include "Sora/Renderer/EditorCamera.h"
+#include "Sora/Scene/SystemScheduler.h"
 
 namespace Sora {
 
@@ -20,18 +21,47 @@ namespace Sora {
 
 		Entity CreateEntity(const std::string& name = std::string(), const std::optional<UUID>& uuid = std::nullopt);
 		void DestroyEntity(Entity entity);
+		// Duplicates the entity and its descendants, which get new UUIDs and keep their local transforms.
 		Entity DuplicateEntity(Entity entity);
 
+		Entity GetEntityByUUID(UUID uuid);
+		Entity GetParent(Entity entity);
+		// Makes 'child' a child of 'parent', or a root when 'parent' is null, by default without moving it. Returns false,
+		// and changes nothing, when 'parent' is 'child' itself or one of its descendants.
+		bool SetParent(Entity child, Entity parent, bool keepWorldTransform = true);
+
 		void OnRuntimeStart();
 		void OnRuntimeStop();
 
 		void OnUpdatePhysics(Timestep ts);
 
+		// Systems run by OnUpdateRuntime(), after the built-in "Scripts" and "Physics" ones, and before the world
+		// transforms are updated and the scene is drawn. They are copied along with the scene, so they should reach
+		// it through the Scene they are given.
+		void RegisterSystem(const std::string& name, const SystemAccess& access, const SystemScheduler::SystemFunction& function);
+		void UnregisterSystem(const std::string& name);
+		const SystemScheduler& GetSystemScheduler() const { return m_Systems; }
+
 		void OnUpdateEditor(Timestep ts, EditorCamera& camera);
 		void OnUpdateRuntime(Timestep ts);
 		void OnViewportResize(uint32_t width, uint32_t height);
 
 		Entity GetPrimaryCameraEntity();
+
+		struct TransformStatistics
+		{
+			uint32_t RecomputedCount = 0;
+			uint32_t ReusedCount = 0;
+		};
+
+		// Rebuilds the world matrices of the entities whose transform, or one of whose ancestors' transforms, changed since
+		// the last call. Called by OnUpdateEditor() and OnUpdateRuntime(), call it before reading WorldTransformComponent
+		// anywhere else.
+		void UpdateWorldTransforms();
+		// Of the last UpdateWorldTransforms().
+		const TransformStatistics& GetTransformStats() const { return m_TransformStats; }
+		// False for handles of destroyed entities, such as ones read back from a frame rendered before they were.
+		bool IsValid(entt::entity handle) const { return m_Registry.valid(handle); }
 		
 		EditorCamera& GetEditorCamera() { return m_EditorCamera; }
 
@@ -43,6 +73,12 @@ namespace Sora {
 	private:
 		template<typename T>
 		void OnComponentAdded(Entity entity, T& component);
+
+		Entity DuplicateEntity(Entity entity, Entity parent);
+
+		void RebuildTransformHierarchy();
+		glm::mat4 GetParentWorldTransform(Entity entity);
+		void UpdateScripts(Timestep ts);
 	private:
 		uint32_t m_ViewportWidth = 0, m_ViewportHeight = 0;
 		b2WorldId m_WorldID = {};
@@ -50,6 +86,25 @@ namespace Sora {
 
 		EditorCamera m_EditorCamera;
 
+		std::unordered_map<UUID, entt::entity> m_EntityMap;
+
+		// Every entity, breadth first from the roots: each depth is a contiguous range, starting at
+		// m_TransformLevels[depth], and parents come before their children. Rebuilt when the hierarchy changes, so that
+		// propagation is a linear sweep, one depth at a time.
+		struct TransformNode
+		{
+			entt::entity Entity;
+			uint32_t Parent;	// Index into m_TransformNodes, UINT32_MAX for roots.
+		};
+		std::vector<TransformNode> m_TransformNodes;
+		std::vector<uint32_t> m_TransformLevels;	// Plus the end of the last level.
+		std::vector<glm::mat4> m_WorldMatrices;	// Per node, read by the children.
+		std::vector<uint8_t> m_WorldChanged;		// Per node, during the last sweep.
+		bool m_HierarchyDirty = true;
+		TransformStatistics m_TransformStats;
+
+		SystemScheduler m_Systems;
+
 		friend class Entity;
 		friend class SceneHierarchyPanel;
 		friend class SceneSerializer;
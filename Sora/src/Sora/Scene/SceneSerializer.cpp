@@ -164,6 +164,21 @@ namespace Sora {
             }
         }
 
+        // Only the children, in order. Parents are restored from them.
+        if (auto& relationshipComponent = entity.GetComponent<RelationshipComponent>(); !relationshipComponent.Children.empty())
+        {
+            out << YAML::Key << "RelationshipComponent";
+            out << YAML::BeginMap;
+            {
+                out << YAML::Key << "Children" << YAML::Value << YAML::Flow << YAML::BeginSeq;
+                for (UUID child : relationshipComponent.Children)
+                    out << (uint64_t)child;
+                out << YAML::EndSeq;
+
+                out << YAML::EndMap;
+            }
+        }
+
         if (entity.HasComponent<SpriteRendererComponent>())
         {
             out << YAML::Key << "SpriteRendererComponent";
@@ -176,6 +191,8 @@ namespace Sora {
                 out << YAML::Key << "Color"	<< YAML::Value << color;
                 if (texture.get())
                     out << YAML::Key << "Texture" << YAML::Value << texture->GetTexturePath().string();
+                out << YAML::Key << "Layer" << YAML::Value << spriteRendererComponent.Layer;
+                out << YAML::Key << "Static" << YAML::Value << spriteRendererComponent.Static;
 
                 out << YAML::EndMap;
             }
@@ -194,6 +211,7 @@ namespace Sora {
                 out << YAML::Key << "Color"     << YAML::Value << color;
                 out << YAML::Key << "Thickness" << YAML::Value << thickness;
                 out << YAML::Key << "Fade"      << YAML::Value << fade;
+                out << YAML::Key << "Layer"     << YAML::Value << circleRendererComponent.Layer;
 
                 out << YAML::EndMap;
             }
@@ -360,6 +378,9 @@ namespace Sora {
         std::string sceneName = GetValue<std::string>(data, "Scene");
         SORA_CORE_TRACE("Deserializing scene '{0}'", sceneName);
 
+        // Linked once every entity exists, since children may come before their parents.
+        std::vector<std::pair<Entity, std::vector<uint64_t>>> relationships;
+
         auto entities = data["Entities"];
         if (entities)
         {
@@ -385,6 +406,10 @@ namespace Sora {
                     componet.Scale       = GetValue<glm::vec3>(transformComponent, "Scale");
                 }
 
+                auto relationshipComponent = entity["RelationshipComponent"];
+                if (relationshipComponent && relationshipComponent["Children"])
+                    relationships.emplace_back(deserializedEntity, relationshipComponent["Children"].as<std::vector<uint64_t>>());
+
                 auto cameraComponent = entity["CameraComponent"];
                 if (cameraComponent)
                 {
@@ -414,8 +439,13 @@ namespace Sora {
                     auto& component = deserializedEntity.AddComponent<SpriteRendererComponent>();
 
                     component.Color = GetValue<glm::vec4>(spriteRendererComponent, "Color");
+                    component.Layer = GetValue<int>(spriteRendererComponent, "Layer");
+                    component.Static = GetValue<bool>(spriteRendererComponent, "Static");
                     if(spriteRendererComponent["Texture"])
-                        component.Texture = Texture2D::Create(GetValue<std::string>(spriteRendererComponent, "Texture"));
+                    {
+                        // Decoded in the background, the renderer packs it into the atlas once it has arrived.
+                        component.Texture = Texture2D::CreateAsync(GetValue<std::string>(spriteRendererComponent, "Texture"));
+                    }
                 }
 
                 auto circleRendererComponent = entity["CircleRendererComponent"];
@@ -426,6 +456,7 @@ namespace Sora {
                     component.Color     = GetValue<glm::vec4>(circleRendererComponent, "Color");
                     component.Thickness = GetValue<float>    (circleRendererComponent, "Thickness");
                     component.Fade      = GetValue<float>    (circleRendererComponent, "Fade");
+                    component.Layer     = GetValue<int>      (circleRendererComponent, "Layer");
                 }
 
                 auto rigidbody2DComponent = entity["Rigidbody2DComponent"];
@@ -460,6 +491,18 @@ namespace Sora {
             }
         }
 
+        for (auto& [parent, children] : relationships)
+        {
+            for (uint64_t uuid : children)
+            {
+                Entity child = m_Scene->GetEntityByUUID(uuid);
+                if (child)
+                    m_Scene->SetParent(child, parent, false);
+                else
+                    SORA_CORE_WARN("Entity '{0}' has a child {1} that is not in the scene", parent.GetName(), uuid);
+            }
+        }
+
         auto editorCamera = data["Camera"];
         if (editorCamera)
         {
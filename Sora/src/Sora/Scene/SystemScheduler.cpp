@@ -0,0 +1,176 @@
+#include "sorapch.h"
+#include "SystemScheduler.h"
+
+#include "Sora/Core/JobSystem.h"
+#include "Sora/Core/Timer.h"
+
+#include <thread>
+
+namespace Sora {
+
+	namespace Utils {
+
+		static bool Intersects(const std::vector<entt::id_type>& a, const std::vector<entt::id_type>& b)
+		{
+			for (entt::id_type id : a)
+			{
+				if (std::find(b.begin(), b.end(), id) != b.end())
+					return true;
+			}
+			return false;
+		}
+
+	}
+
+	bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+	{
+		if (Exclusive || other.Exclusive)
+			return true;
+
+		return Utils::Intersects(Writes, other.Writes) || Utils::Intersects(Writes, other.Reads) || Utils::Intersects(Reads, other.Writes);
+	}
+
+	// What one Run() shares with its jobs. Lives on the stack of Run(), which returns only after the last system took
+	// RemainingCount to zero, the last thing a system does.
+	struct SystemScheduler::Frame
+	{
+		Scene& ActiveScene;
+		Timestep Ts;
+
+		std::vector<std::atomic<uint32_t>> PendingPredecessors;
+		std::atomic<uint32_t> RemainingCount = 0;
+
+		std::mutex MainThreadMutex;
+		std::vector<uint32_t> MainThreadReady;
+	};
+
+	void SystemScheduler::AddSystem(const std::string& name, const SystemAccess& access, const SystemFunction& function)
+	{
+		m_Systems.push_back({ name, access, function });
+		m_GraphDirty = true;
+	}
+
+	void SystemScheduler::RemoveSystem(const std::string& name)
+	{
+		auto it = std::find_if(m_Systems.begin(), m_Systems.end(), [&name](const System& system) { return system.Name == name; });
+		if (it == m_Systems.end())
+			return;
+
+		m_Systems.erase(it);
+		m_GraphDirty = true;
+	}
+
+	void SystemScheduler::BuildGraph()
+	{
+		SORA_PROFILE_FUNCTION();
+
+		for (System& system : m_Systems)
+		{
+			system.Successors.clear();
+			system.PredecessorCount = 0;
+		}
+
+		// Only ever from earlier to later systems, so the graph has no cycles and conflicts keep registration order.
+		for (uint32_t j = 0; j < m_Systems.size(); j++)
+		{
+			for (uint32_t i = 0; i < j; i++)
+			{
+				if (m_Systems[i].Access.ConflictsWith(m_Systems[j].Access))
+				{
+					m_Systems[i].Successors.push_back(j);
+					m_Systems[j].PredecessorCount++;
+				}
+			}
+		}
+
+		m_Stats.resize(m_Systems.size());
+		for (size_t i = 0; i < m_Systems.size(); i++)
+			m_Stats[i] = { m_Systems[i].Name, 0.0f };
+
+		m_GraphDirty = false;
+	}
+
+	void SystemScheduler::Run(Scene& scene, entt::registry& registry, Timestep ts)
+	{
+		SORA_PROFILE_FUNCTION();
+
+		if (m_GraphDirty)
+			BuildGraph();
+
+		if (m_Systems.empty())
+			return;
+
+		for (const System& system : m_Systems)
+		{
+			for (auto createStorage : system.Access.Storages)
+				createStorage(registry);
+		}
+
+		Timer timer;
+
+		Frame frame = { scene, ts, std::vector<std::atomic<uint32_t>>(m_Systems.size()) };
+		frame.RemainingCount = (uint32_t)m_Systems.size();
+		for (uint32_t i = 0; i < m_Systems.size(); i++)
+			frame.PendingPredecessors[i] = m_Systems[i].PredecessorCount;
+
+		for (uint32_t i = 0; i < m_Systems.size(); i++)
+		{
+			if (m_Systems[i].PredecessorCount == 0)
+				Start(frame, i);
+		}
+
+		// Runs the main thread systems as they become ready, and helps with the jobs in between.
+		while (frame.RemainingCount.load(std::memory_order_acquire) > 0)
+		{
+			uint32_t index = UINT32_MAX;
+			{
+				std::lock_guard<std::mutex> lock(frame.MainThreadMutex);
+				if (!frame.MainThreadReady.empty())
+				{
+					index = frame.MainThreadReady.front();
+					frame.MainThreadReady.erase(frame.MainThreadReady.begin());
+				}
+			}
+
+			if (index != UINT32_MAX)
+				Execute(frame, index);
+			else if (!JobSystem::TryRunJob())
+				std::this_thread::yield();
+		}
+
+		m_FrameTime = timer.ElapsedMillis();
+	}
+
+	void SystemScheduler::Start(Frame& frame, uint32_t index)
+	{
+		if (m_Systems[index].Access.MainThread)
+		{
+			std::lock_guard<std::mutex> lock(frame.MainThreadMutex);
+			frame.MainThreadReady.push_back(index);
+			return;
+		}
+
+		JobSystem::Run([this, &frame, index]() { Execute(frame, index); });
+	}
+
+	void SystemScheduler::Execute(Frame& frame, uint32_t index)
+	{
+		const System& system = m_Systems[index];
+		{
+			SORA_PROFILE_SCOPE(system.Name.c_str());
+
+			Timer timer;
+			system.Function(frame.ActiveScene, frame.Ts);
+			m_Stats[index].Time = timer.ElapsedMillis();
+		}
+
+		for (uint32_t successor : system.Successors)
+		{
+			if (frame.PendingPredecessors[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+				Start(frame, successor);
+		}
+
+		frame.RemainingCount.fetch_sub(1, std::memory_order_release);
+	}
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <entt.hpp>
+
+#include "Sora/Core/Timestep.h"
+
+namespace Sora {
+
+	class Scene;
+
+	// The components a system reads and writes. Systems that write a component another one reads or writes are
+	// ordered; the rest may run at the same time.
+	struct SystemAccess
+	{
+		std::vector<entt::id_type> Reads;
+		std::vector<entt::id_type> Writes;
+		// Creates the storages up front: creating one changes the registry, which other threads may be reading.
+		std::vector<void(*)(entt::registry&)> Storages;
+
+		// Conflicts with every other system, e.g. for creating or destroying entities.
+		bool Exclusive = false;
+		// Runs on the thread that updates the scene, e.g. for input or anything that talks to the renderer.
+		bool MainThread = false;
+
+		template<typename... Components>
+		SystemAccess& Read()
+		{
+			(Add<Components>(Reads), ...);
+			return *this;
+		}
+
+		template<typename... Components>
+		SystemAccess& Write()
+		{
+			(Add<Components>(Writes), ...);
+			return *this;
+		}
+
+		SystemAccess& SetExclusive() { Exclusive = true; return *this; }
+		SystemAccess& SetMainThread() { MainThread = true; return *this; }
+
+		bool ConflictsWith(const SystemAccess& other) const;
+	private:
+		template<typename Component>
+		void Add(std::vector<entt::id_type>& ids)
+		{
+			ids.push_back(entt::type_hash<Component>::value());
+			Storages.push_back([](entt::registry& registry) { registry.storage<Component>(); });
+		}
+	};
+
+	// Runs the systems of a scene on the job system. Of two conflicting systems, the one registered first runs first,
+	// so a frame gives the same results as running them one by one in registration order.
+	class SystemScheduler
+	{
+	public:
+		using SystemFunction = std::function<void(Scene&, Timestep)>;
+
+		struct SystemStatistics
+		{
+			std::string Name;
+			float Time = 0.0f;	// In milliseconds, of the last Run().
+		};
+
+		void AddSystem(const std::string& name, const SystemAccess& access, const SystemFunction& function);
+		void RemoveSystem(const std::string& name);
+
+		// Returns once every system is done.
+		void Run(Scene& scene, entt::registry& registry, Timestep ts);
+
+		const std::vector<SystemStatistics>& GetStats() const { return m_Stats; }
+		// Of the last Run(), from the first system starting to the last one finishing.
+		float GetFrameTime() const { return m_FrameTime; }
+	private:
+		struct Frame;
+
+		void BuildGraph();
+		void Start(Frame& frame, uint32_t index);
+		void Execute(Frame& frame, uint32_t index);
+	private:
+		struct System
+		{
+			std::string Name;
+			SystemAccess Access;
+			SystemFunction Function;
+
+			// Later systems that conflict with this one.
+			std::vector<uint32_t> Successors;
+			uint32_t PredecessorCount = 0;
+		};
+
+		std::vector<System> m_Systems;
+		std::vector<SystemStatistics> m_Stats;
+		float m_FrameTime = 0.0f;
+		bool m_GraphDirty = true;
+	};
+
+}
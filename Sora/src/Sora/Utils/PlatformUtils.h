@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <filesystem>
 
 namespace Sora {
 
@@ -11,4 +13,24 @@ namespace Sora {
 		static std::string SaveFile(const char* filter);
 	};
 
+	// Read-only view of a whole file, paged in by the OS as it is touched.
+	class MappedFile
+	{
+	public:
+		MappedFile(const std::filesystem::path& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool IsValid() const { return m_Data != nullptr; }
+		const uint8_t* GetData() const { return m_Data; }
+		size_t GetSize() const { return m_Size; }
+	private:
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+	};
+
 }
\ No newline at end of file
@@ -52,46 +52,52 @@ struct VertexOutput
 layout(location = 0) in VertexOutput Input;
 layout(location = 4) in flat int v_EntityID;
 
-layout(binding = 0) uniform sampler2D u_Textures[32];
+layout(binding = 0) uniform sampler2D u_Textures[24];
+layout(binding = 24) uniform sampler2DArray u_TextureArrays[8];
 
 void main()
 {
 	o_Color = Input.Color;
 
-	switch (int(Input.TexIndex)) 
+	// Low 8 bits select the sampler, the rest is the layer inside a texture array.
+	int index = int(Input.TexIndex + 0.5);
+	vec2 texCoord = Input.TexCoord * Input.TilingFactor;
+	vec3 layerCoord = vec3(texCoord, float(index >> 8));
+
+	switch (index & 0xFF) 
 	{
-		case  0: o_Color *= texture(u_Textures[ 0], Input.TexCoord * Input.TilingFactor); break;
-		case  1: o_Color *= texture(u_Textures[ 1], Input.TexCoord * Input.TilingFactor); break;
-		case  2: o_Color *= texture(u_Textures[ 2], Input.TexCoord * Input.TilingFactor); break;
-		case  3: o_Color *= texture(u_Textures[ 3], Input.TexCoord * Input.TilingFactor); break;
-		case  4: o_Color *= texture(u_Textures[ 4], Input.TexCoord * Input.TilingFactor); break;
-		case  5: o_Color *= texture(u_Textures[ 5], Input.TexCoord * Input.TilingFactor); break;
-		case  6: o_Color *= texture(u_Textures[ 6], Input.TexCoord * Input.TilingFactor); break;
-		case  7: o_Color *= texture(u_Textures[ 7], Input.TexCoord * Input.TilingFactor); break;
-		case  8: o_Color *= texture(u_Textures[ 8], Input.TexCoord * Input.TilingFactor); break;
-		case  9: o_Color *= texture(u_Textures[ 9], Input.TexCoord * Input.TilingFactor); break;
-		case 10: o_Color *= texture(u_Textures[10], Input.TexCoord * Input.TilingFactor); break;
-		case 11: o_Color *= texture(u_Textures[11], Input.TexCoord * Input.TilingFactor); break;
-		case 12: o_Color *= texture(u_Textures[12], Input.TexCoord * Input.TilingFactor); break;
-		case 13: o_Color *= texture(u_Textures[13], Input.TexCoord * Input.TilingFactor); break;
-		case 14: o_Color *= texture(u_Textures[14], Input.TexCoord * Input.TilingFactor); break;
-		case 15: o_Color *= texture(u_Textures[15], Input.TexCoord * Input.TilingFactor); break;
-		case 16: o_Color *= texture(u_Textures[16], Input.TexCoord * Input.TilingFactor); break;
-		case 17: o_Color *= texture(u_Textures[17], Input.TexCoord * Input.TilingFactor); break;
-		case 18: o_Color *= texture(u_Textures[18], Input.TexCoord * Input.TilingFactor); break;
-		case 19: o_Color *= texture(u_Textures[19], Input.TexCoord * Input.TilingFactor); break;
-		case 20: o_Color *= texture(u_Textures[20], Input.TexCoord * Input.TilingFactor); break;
-		case 21: o_Color *= texture(u_Textures[21], Input.TexCoord * Input.TilingFactor); break;
-		case 22: o_Color *= texture(u_Textures[22], Input.TexCoord * Input.TilingFactor); break;
-		case 23: o_Color *= texture(u_Textures[23], Input.TexCoord * Input.TilingFactor); break;
-		case 24: o_Color *= texture(u_Textures[24], Input.TexCoord * Input.TilingFactor); break;
-		case 25: o_Color *= texture(u_Textures[25], Input.TexCoord * Input.TilingFactor); break;
-		case 26: o_Color *= texture(u_Textures[26], Input.TexCoord * Input.TilingFactor); break;
-		case 27: o_Color *= texture(u_Textures[27], Input.TexCoord * Input.TilingFactor); break;
-		case 28: o_Color *= texture(u_Textures[28], Input.TexCoord * Input.TilingFactor); break;
-		case 29: o_Color *= texture(u_Textures[29], Input.TexCoord * Input.TilingFactor); break;
-		case 30: o_Color *= texture(u_Textures[30], Input.TexCoord * Input.TilingFactor); break;
-		case 31: o_Color *= texture(u_Textures[31], Input.TexCoord * Input.TilingFactor); break;
+		case  0: o_Color *= texture(u_Textures[ 0], texCoord); break;
+		case  1: o_Color *= texture(u_Textures[ 1], texCoord); break;
+		case  2: o_Color *= texture(u_Textures[ 2], texCoord); break;
+		case  3: o_Color *= texture(u_Textures[ 3], texCoord); break;
+		case  4: o_Color *= texture(u_Textures[ 4], texCoord); break;
+		case  5: o_Color *= texture(u_Textures[ 5], texCoord); break;
+		case  6: o_Color *= texture(u_Textures[ 6], texCoord); break;
+		case  7: o_Color *= texture(u_Textures[ 7], texCoord); break;
+		case  8: o_Color *= texture(u_Textures[ 8], texCoord); break;
+		case  9: o_Color *= texture(u_Textures[ 9], texCoord); break;
+		case 10: o_Color *= texture(u_Textures[10], texCoord); break;
+		case 11: o_Color *= texture(u_Textures[11], texCoord); break;
+		case 12: o_Color *= texture(u_Textures[12], texCoord); break;
+		case 13: o_Color *= texture(u_Textures[13], texCoord); break;
+		case 14: o_Color *= texture(u_Textures[14], texCoord); break;
+		case 15: o_Color *= texture(u_Textures[15], texCoord); break;
+		case 16: o_Color *= texture(u_Textures[16], texCoord); break;
+		case 17: o_Color *= texture(u_Textures[17], texCoord); break;
+		case 18: o_Color *= texture(u_Textures[18], texCoord); break;
+		case 19: o_Color *= texture(u_Textures[19], texCoord); break;
+		case 20: o_Color *= texture(u_Textures[20], texCoord); break;
+		case 21: o_Color *= texture(u_Textures[21], texCoord); break;
+		case 22: o_Color *= texture(u_Textures[22], texCoord); break;
+		case 23: o_Color *= texture(u_Textures[23], texCoord); break;
+		case 24: o_Color *= texture(u_TextureArrays[0], layerCoord); break;
+		case 25: o_Color *= texture(u_TextureArrays[1], layerCoord); break;
+		case 26: o_Color *= texture(u_TextureArrays[2], layerCoord); break;
+		case 27: o_Color *= texture(u_TextureArrays[3], layerCoord); break;
+		case 28: o_Color *= texture(u_TextureArrays[4], layerCoord); break;
+		case 29: o_Color *= texture(u_TextureArrays[5], layerCoord); break;
+		case 30: o_Color *= texture(u_TextureArrays[6], layerCoord); break;
+		case 31: o_Color *= texture(u_TextureArrays[7], layerCoord); break;
 	}
 
 	if (o_Color.a == 0.0)
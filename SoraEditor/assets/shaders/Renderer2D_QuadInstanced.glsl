@@ -0,0 +1,115 @@
+#type vertex
+#version 450 core
+
+// Per-vertex: corner of the unit quad.
+layout(location = 0) in vec2 a_LocalPosition;
+
+// Per-instance
+layout(location = 1) in vec4  a_Basis;
+layout(location = 2) in vec3  a_Translation;
+layout(location = 3) in uint  a_Color;
+layout(location = 4) in uvec2 a_TexRect;
+layout(location = 5) in int   a_TexIndex;
+layout(location = 6) in float a_TilingFactor;
+layout(location = 7) in int   a_EntityID;
+
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 u_ViewProjection;
+};
+
+struct VertexOutput
+{
+	vec4  Color;
+	vec2  TexCoord;
+	float TilingFactor;
+};
+
+layout (location = 0) out VertexOutput Output;
+layout (location = 3) out flat int v_TexIndex;
+layout (location = 4) out flat int v_EntityID;
+
+void main()
+{
+	vec2 corner = a_LocalPosition + 0.5;
+
+	Output.Color = unpackUnorm4x8(a_Color);
+	Output.TexCoord = mix(unpackUnorm2x16(a_TexRect.x), unpackUnorm2x16(a_TexRect.y), corner);
+	Output.TilingFactor = a_TilingFactor;
+	v_TexIndex = a_TexIndex;
+	v_EntityID = a_EntityID;
+
+	vec2 position = a_Translation.xy + a_Basis.xy * a_LocalPosition.x + a_Basis.zw * a_LocalPosition.y;
+	gl_Position = u_ViewProjection * vec4(position, a_Translation.z, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 o_Color;
+layout(location = 1) out int o_EntityID;
+
+struct VertexOutput
+{
+	vec4  Color;
+	vec2  TexCoord;
+	float TilingFactor;
+};
+
+layout(location = 0) in VertexOutput Input;
+layout(location = 3) in flat int v_TexIndex;
+layout(location = 4) in flat int v_EntityID;
+
+layout(binding = 0) uniform sampler2D u_Textures[24];
+layout(binding = 24) uniform sampler2DArray u_TextureArrays[8];
+
+void main()
+{
+	o_Color = Input.Color;
+
+	// Low 8 bits select the sampler, the rest is the layer inside a texture array.
+	int index = v_TexIndex;
+	vec2 texCoord = Input.TexCoord * Input.TilingFactor;
+	vec3 layerCoord = vec3(texCoord, float(index >> 8));
+
+	switch (index & 0xFF) 
+	{
+		case  0: o_Color *= texture(u_Textures[ 0], texCoord); break;
+		case  1: o_Color *= texture(u_Textures[ 1], texCoord); break;
+		case  2: o_Color *= texture(u_Textures[ 2], texCoord); break;
+		case  3: o_Color *= texture(u_Textures[ 3], texCoord); break;
+		case  4: o_Color *= texture(u_Textures[ 4], texCoord); break;
+		case  5: o_Color *= texture(u_Textures[ 5], texCoord); break;
+		case  6: o_Color *= texture(u_Textures[ 6], texCoord); break;
+		case  7: o_Color *= texture(u_Textures[ 7], texCoord); break;
+		case  8: o_Color *= texture(u_Textures[ 8], texCoord); break;
+		case  9: o_Color *= texture(u_Textures[ 9], texCoord); break;
+		case 10: o_Color *= texture(u_Textures[10], texCoord); break;
+		case 11: o_Color *= texture(u_Textures[11], texCoord); break;
+		case 12: o_Color *= texture(u_Textures[12], texCoord); break;
+		case 13: o_Color *= texture(u_Textures[13], texCoord); break;
+		case 14: o_Color *= texture(u_Textures[14], texCoord); break;
+		case 15: o_Color *= texture(u_Textures[15], texCoord); break;
+		case 16: o_Color *= texture(u_Textures[16], texCoord); break;
+		case 17: o_Color *= texture(u_Textures[17], texCoord); break;
+		case 18: o_Color *= texture(u_Textures[18], texCoord); break;
+		case 19: o_Color *= texture(u_Textures[19], texCoord); break;
+		case 20: o_Color *= texture(u_Textures[20], texCoord); break;
+		case 21: o_Color *= texture(u_Textures[21], texCoord); break;
+		case 22: o_Color *= texture(u_Textures[22], texCoord); break;
+		case 23: o_Color *= texture(u_Textures[23], texCoord); break;
+		case 24: o_Color *= texture(u_TextureArrays[0], layerCoord); break;
+		case 25: o_Color *= texture(u_TextureArrays[1], layerCoord); break;
+		case 26: o_Color *= texture(u_TextureArrays[2], layerCoord); break;
+		case 27: o_Color *= texture(u_TextureArrays[3], layerCoord); break;
+		case 28: o_Color *= texture(u_TextureArrays[4], layerCoord); break;
+		case 29: o_Color *= texture(u_TextureArrays[5], layerCoord); break;
+		case 30: o_Color *= texture(u_TextureArrays[6], layerCoord); break;
+		case 31: o_Color *= texture(u_TextureArrays[7], layerCoord); break;
+	}
+
+	if (o_Color.a == 0.0)
+		discard;
+	
+	o_EntityID = v_EntityID;
+}
\ No newline at end of file
@@ -36,6 +36,8 @@ namespace Sora {
 		m_SceneHierarchyPanel.SetContext(m_EditorScene);
 
 		m_ActiveScene = m_EditorScene;
+
+		Renderer2D::GetShaderLibrary().SetHotReload(true);
 	}
 
 	void EditorLayer::OnDetach()
@@ -53,41 +55,77 @@ namespace Sora {
 			m_ActiveScene->OnViewportResize((uint32_t)m_ViewportSize.x, (uint32_t)m_ViewportSize.y);
 		}
 
+		Renderer2D::GetShaderLibrary().OnUpdate();
+
 		Renderer2D::ResetStats();
-		m_Framebuffer->Bind();
-		RenderCommand::SetClearColor({ 0.1f, 0.1f, 0.1f, 1 });
-		RenderCommand::Clear();
-		m_Framebuffer->ClearAttachment(1, -1);
 
-		switch (m_SceneState)
+		m_RenderGraph.Reset();
+		RenderGraphTarget viewport = m_RenderGraph.ImportTarget("Viewport", m_Framebuffer);
+		m_RenderGraph.SetOutput(viewport, 0);
+
+		// Also updates the scene, so it runs whether or not anything shows what it renders.
+		m_RenderGraph.AddPass("Scene", [&](RenderGraph::PassBuilder& builder)
 		{
-		case SceneState::Edit:
-			m_ActiveScene->GetEditorCamera().OnUpdate(ts);
-			m_ActiveScene->OnUpdateEditor(ts, m_ActiveScene->GetEditorCamera());
-			break;
-		case SceneState::Play:
-			m_ActiveScene->OnUpdateRuntime(ts);
-			break;
-		}
+			builder.Clear(viewport, 0, glm::vec4(0.1f, 0.1f, 0.1f, 1.0f));
+			builder.Clear(viewport, 1, -1);
+			builder.ClearDepth(viewport);
+			builder.SetSideEffects();
+		},
+		[&]()
+		{
+			switch (m_SceneState)
+			{
+			case SceneState::Edit:
+				m_ActiveScene->GetEditorCamera().OnUpdate(ts);
+				m_ActiveScene->OnUpdateEditor(ts, m_ActiveScene->GetEditorCamera());
+				break;
+			case SceneState::Play:
+				m_ActiveScene->OnUpdateRuntime(ts);
+				break;
+			}
+		});
 
-		auto mouse = ImGui::GetMousePos();
-		mouse.x -= m_ViewportBounds[0].x;
-		mouse.y -= m_ViewportBounds[0].y;
-		glm::vec2 viewportSize = m_ViewportBounds[1] - m_ViewportBounds[0];
-		mouse.y = viewportSize.y - mouse.y; // flip for OpenGL coordinate system.
+		// Before the overlay, which writes -1 over the entity IDs it covers.
+		m_RenderGraph.AddPass("Picking", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder.Read(viewport, 1);
+			builder.SetSideEffects();
+		},
+		[&]()
+		{
+			auto mouse = ImGui::GetMousePos();
+			mouse.x -= m_ViewportBounds[0].x;
+			mouse.y -= m_ViewportBounds[0].y;
+			glm::vec2 viewportSize = m_ViewportBounds[1] - m_ViewportBounds[0];
+			mouse.y = viewportSize.y - mouse.y; // flip for OpenGL coordinate system.
 
-		int mouseX = (int)mouse.x;
-		int mouseY = (int)mouse.y;
+			int mouseX = (int)mouse.x;
+			int mouseY = (int)mouse.y;
 
-		if (mouseX >= 0 && mouseY >= 0 && mouseX < (int)viewportSize.x && mouseY < (int)viewportSize.y)
-		{
-			int pixelData = m_Framebuffer->ReadPixel(1, mouseX, mouseY);
-			m_HoveredEntity = pixelData == -1 ? Entity() : Entity((entt::entity)pixelData, m_ActiveScene.get());
-		}
+			// The entity under the mouse arrives a frame or two late, so that picking never waits for the GPU.
+			if (mouseX >= 0 && mouseY >= 0 && mouseX < (int)viewportSize.x && mouseY < (int)viewportSize.y)
+				m_Framebuffer->RequestReadback(1, mouseX, mouseY);
 
-		OnOverlayRender();
+			FramebufferReadback readback;
+			while (m_Framebuffer->PollReadback(readback))
+			{
+				int pixelData = readback.Pixels[0];
+				m_HoveredEntity = pixelData == -1 || !m_ActiveScene->IsValid((entt::entity)pixelData) ? Entity() : Entity((entt::entity)pixelData, m_ActiveScene.get());
+			}
+		});
 
-		m_Framebuffer->Unbind();
+		m_RenderGraph.AddPass("Overlay", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder.Write(viewport, 0);
+			builder.Write(viewport, 1);
+			builder.Write(viewport, RenderGraph::DepthAttachment);
+		},
+		[&]()
+		{
+			OnOverlayRender();
+		});
+
+		m_RenderGraph.Execute();
 	}
 
 	void EditorLayer::OnImGuiRender()
@@ -164,6 +202,7 @@ namespace Sora {
 			m_ContentBrowserPanel.OnImGuiRender();
 			UI_Toolbar();
 			UI_Viewport();
+			UI_Stats();
 	
 			ImGui::End();
 		}
@@ -250,9 +289,9 @@ namespace Sora {
 					return;
 
 				auto& camera = entity.GetComponent<CameraComponent>();
-				auto& transform = entity.GetComponent<TransformComponent>();
+				auto& transform = entity.GetComponent<WorldTransformComponent>();
 
-				Renderer2D::BeginScene(camera.Camera, transform.GetTransform());
+				Renderer2D::BeginScene(camera.Camera, transform.Transform);
 
 				break;
 			}
@@ -429,8 +468,11 @@ namespace Sora {
 
 			Application::Get().GetImGuiLayer()->EnableEvents(m_ViewportFocused || m_ViewportHovered);
 
+			// The framebuffer fills the bottom left corner of its attachments, which may be larger.
+			const FramebufferSpecification& spec = m_Framebuffer->GetSpecification();
+			ImVec2 uvMax = { (float)spec.Width / m_Framebuffer->GetAttachmentWidth(), (float)spec.Height / m_Framebuffer->GetAttachmentHeight() };
 			uint32_t textureID = m_Framebuffer->GetColorAttachmentRendererID();
-			ImGui::Image((void*)(uint64_t)textureID, ImVec2(m_ViewportSize.x, m_ViewportSize.y), ImVec2(0.0f, 1.0f), ImVec2(1.0f, 0.0f));
+			ImGui::Image((void*)(uint64_t)textureID, ImVec2(m_ViewportSize.x, m_ViewportSize.y), ImVec2(0.0f, uvMax.y), ImVec2(uvMax.x, 0.0f));
 
 			if (ImGui::BeginDragDropTarget())
 			{
@@ -466,12 +508,12 @@ namespace Sora {
 					auto cameraEntity	= m_ActiveScene->GetPrimaryCameraEntity();
 					const auto& camera	= cameraEntity.GetComponent<CameraComponent>().Camera;
 					cameraProjection	= camera.GetProjection();
-					cameraView			= glm::inverse(cameraEntity.GetComponent<TransformComponent>().GetTransform());
+					cameraView			= glm::inverse(cameraEntity.GetComponent<WorldTransformComponent>().Transform);
 					break;
 				}
 
 				auto& transformComponent = selectedEntity.GetComponent<TransformComponent>();
-				glm::mat4 transform = transformComponent.GetTransform();
+				glm::mat4 transform = selectedEntity.GetComponent<WorldTransformComponent>().Transform;
 
 				// edit snap value here!
 				bool snap = Input::IsKeyPressed(KeyCode::LeftControl);
@@ -488,6 +530,10 @@ namespace Sora {
 
 				if (ImGuizmo::IsUsing())
 				{
+					// The gizmo works in world space, the component holds the transform relative to the parent.
+					if (Entity parent = m_ActiveScene->GetParent(selectedEntity))
+						transform = glm::inverse(parent.GetComponent<WorldTransformComponent>().Transform) * transform;
+
 					glm::vec3 translation, rotation, scale;
 					Math::DecomposeTransform(transform, translation, rotation, scale);
 
@@ -502,6 +548,81 @@ namespace Sora {
 		}
 	}
 
+	void EditorLayer::UI_Stats()
+	{
+		if (ImGui::Begin("Stats"))
+		{
+			auto stats = Renderer2D::GetStats();
+			ImGui::Text("Renderer2D Stats:");
+			ImGui::Text("Draw Calls: %d", stats.DrawCallCount);
+			ImGui::Text("Quads: %d", stats.QuadCount);
+			ImGui::Text("Instanced Quads: %d", stats.InstancedQuadCount);
+			ImGui::Text("Vertices: %d", stats.GetTotalVertexCount());
+			ImGui::Text("Indices: %d", stats.GetTotalIndexCount());
+			ImGui::Text("Uploaded: %.1f KB", stats.UploadedBytes / 1024.0f);
+			ImGui::Text("State Changes Avoided: %d", stats.StateChangesAvoided);
+			ImGui::Text("Visible: %d", stats.VisibleCount);
+			ImGui::Text("Culled: %d", stats.CulledCount);
+			ImGui::Text("Static Quads: %d", stats.StaticQuadCount);
+			ImGui::Text("Static Batch Rebuilds: %d", stats.StaticBatchRebuilds);
+			ImGui::Text("Indirect Draws: %d", stats.IndirectDrawCount);
+
+			auto atlasStats = Renderer2D::GetTextureAtlas().GetStats();
+			ImGui::Text("Atlas Pages: %d", atlasStats.PageCount);
+			ImGui::Text("Atlas Textures: %d", atlasStats.TextureCount);
+			ImGui::Text("Atlas Efficiency: %.1f%%", atlasStats.GetPackingEfficiency() * 100.0f);
+
+			auto streamerStats = Renderer::GetTextureStreamer().GetStats();
+			ImGui::Text("Textures Decoding: %d", streamerStats.PendingDecodes);
+			ImGui::Text("Textures Uploading: %d", streamerStats.PendingUploads);
+			ImGui::Text("Texture Upload: %.1f KB", streamerStats.UploadedBytes / 1024.0f);
+
+			auto poolStats = Renderer::GetRenderTargetPool()->GetStats();
+			ImGui::Text("Render Targets: %d (%d in use)", poolStats.TextureCount, poolStats.InUseCount);
+			ImGui::Text("Render Target Memory: %.1f MB (%.1f MB in use)", poolStats.AllocatedBytes / (1024.0f * 1024.0f), poolStats.InUseBytes / (1024.0f * 1024.0f));
+			ImGui::Text("Render Target Allocations: %d (%d reused)", poolStats.Allocations, poolStats.Reuses);
+
+			auto graphStats = m_RenderGraph.GetStats();
+			ImGui::Text("Render Passes: %d (%d culled)", graphStats.PassCount, graphStats.CulledPassCount);
+			ImGui::Text("Attachment Clears: %d", graphStats.ClearCount);
+
+			auto transformStats = m_ActiveScene->GetTransformStats();
+			ImGui::Text("World Transforms: %d recomputed, %d reused", transformStats.RecomputedCount, transformStats.ReusedCount);
+
+			if (m_SceneState == SceneState::Play)
+			{
+				const auto& systems = m_ActiveScene->GetSystemScheduler();
+				ImGui::Text("Systems: %.2f ms", systems.GetFrameTime());
+				for (const auto& system : systems.GetStats())
+					ImGui::Text("  %s: %.2f ms", system.Name.c_str(), system.Time);
+			}
+
+			bool instancing = Renderer2D::GetQuadInstancing();
+			if (ImGui::Checkbox("Instanced Quads", &instancing))
+				Renderer2D::SetQuadInstancing(instancing);
+
+			bool multiDrawIndirect = Renderer2D::GetMultiDrawIndirect();
+			if (ImGui::Checkbox("Multi-Draw Indirect", &multiDrawIndirect))
+				Renderer2D::SetMultiDrawIndirect(multiDrawIndirect);
+
+			auto& shaderLibrary = Renderer2D::GetShaderLibrary();
+			bool hotReload = shaderLibrary.IsHotReloadEnabled();
+			if (ImGui::Checkbox("Shader Hot Reload", &hotReload))
+				shaderLibrary.SetHotReload(hotReload);
+
+			// Most recent first.
+			const auto& reloads = shaderLibrary.GetReloadHistory();
+			for (auto it = reloads.rbegin(); it != reloads.rend(); ++it)
+			{
+				if (it->Succeeded)
+					ImGui::Text("%s: %.1f ms (compile %.1f ms)", it->Name.c_str(), it->TotalMilliseconds, it->CompileMilliseconds);
+				else
+					ImGui::TextColored({ 1.0f, 0.3f, 0.3f, 1.0f }, "%s: failed, see log", it->Name.c_str());
+			}
+		}
+		ImGui::End();
+	}
+
 	void EditorLayer::UI_DockspaceSetup()
 	{
 		static bool firstLoop = true;
@@ -551,6 +672,7 @@ namespace Sora {
 		ImGui::DockBuilderDockWindow("Viewport", DockCenterID);
 		ImGui::DockBuilderDockWindow("Scene Hierarchy", DockLeftID);
 		ImGui::DockBuilderDockWindow("Properties", DockRightID);
+		ImGui::DockBuilderDockWindow("Stats", DockRightID);
 		ImGui::DockBuilderDockWindow("Content Browser", DockBottomID);
 		ImGui::DockBuilderDockWindow("##Toolbar", DockTopID);
 
@@ -35,6 +35,7 @@ namespace Sora {
 		// UI
 		void UI_Toolbar();
 		void UI_Viewport();
+		void UI_Stats();
 		void UI_DockspaceSetup();
 
 		void OnScenePlay();
@@ -43,6 +44,7 @@ namespace Sora {
 		void DuplicateEntity();
 	private:
 		Ref<Framebuffer> m_Framebuffer;
+		RenderGraph m_RenderGraph;
 
 		Ref<Scene> m_ActiveScene;
 		Ref<Scene> m_EditorScene, m_RuntimeScene;
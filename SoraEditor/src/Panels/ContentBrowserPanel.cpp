@@ -16,6 +16,21 @@ namespace Sora {
 		mFileIcon = Texture2D::Create("resources/icons/ContentBrowser/FileIcon.png");
 	}
 
+	Ref<Texture2D> ContentBrowserPanel::GetThumbnail(const std::filesystem::path& path)
+	{
+		std::string extension = path.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower(c); });
+		if (extension != ".png" && extension != ".jpg" && extension != ".jpeg" && extension != ".tga" && extension != ".bmp")
+			return mFileIcon;
+
+		const std::string key = path.string();
+		auto it = mThumbnails.find(key);
+		if (it == mThumbnails.end())
+			it = mThumbnails.emplace(key, Texture2D::CreateThumbnailAsync(key, ThumbnailResolution)).first;
+
+		return it->second && it->second->IsLoaded() ? it->second : mFileIcon;
+	}
+
 	void ContentBrowserPanel::OnImGuiRender()
 	{
 		if (ImGui::Begin("Content Browser"))
@@ -25,6 +40,7 @@ namespace Sora {
 				if (ImGui::Button("<-"))
 				{
 					mCurrentDirectory = mCurrentDirectory.parent_path();
+					mThumbnails.clear();
 				}
 			}
 
@@ -45,7 +61,7 @@ namespace Sora {
 				auto relativePath = std::filesystem::relative(directory.path(), gAssetPath);
 				std::string filename = relativePath.filename().string();
 
-				Ref<Texture2D> icon = directory.is_directory() ? mDirectoryIcon : mFileIcon;
+				Ref<Texture2D> icon = directory.is_directory() ? mDirectoryIcon : GetThumbnail(path);
 				ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0, 0, 0, 0));
 				ImGui::ImageButton(filename.c_str(), (ImTextureID)(uint64_t)icon->GetRendererID(), {thumbnailSize, thumbnailSize}, {0, 1}, {1, 0});
 				if (ImGui::BeginDragDropSource())
@@ -60,7 +76,10 @@ namespace Sora {
 				if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left))
 				{
 					if (directory.is_directory())
+					{
 						mCurrentDirectory /= path.filename();
+						mThumbnails.clear();
+					}
 				}
 				ImGui::TextWrapped(filename.c_str());
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <unordered_map>
 
 #include "Sora/Renderer/Texture.h"
 
@@ -13,9 +14,16 @@ namespace Sora {
 
 		void OnImGuiRender();
 	private:
+		// Image files show themselves, as thumbnails that are streamed in and cached like textures. mFileIcon stands in
+		// until they are loaded.
+		Ref<Texture2D> GetThumbnail(const std::filesystem::path& path);
+	private:
+		static constexpr uint32_t ThumbnailResolution = 128;	// The size of the buttons.
+
 		std::filesystem::path mCurrentDirectory;
 	
 		Ref<Texture2D> mDirectoryIcon, mFileIcon;
+		std::unordered_map<std::string, Ref<Texture2D>> mThumbnails;	// For mCurrentDirectory only.
 	};
 
 }
\ No newline at end of file
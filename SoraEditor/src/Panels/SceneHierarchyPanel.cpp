@@ -23,10 +23,22 @@ namespace Sora {
 	{
 		if (ImGui::Begin("Scene Hierarchy"))
 		{
-			auto view = m_Context->m_Registry.view<TagComponent>();
+			// Roots only, children are drawn inside their parent's node.
+			auto view = m_Context->m_Registry.view<TagComponent, RelationshipComponent>();
 			for (auto entity : view)
 			{
-				DrawEntityNode(Entity(entity, m_Context.get()));
+				if (!view.get<RelationshipComponent>(entity).Parent)
+					DrawEntityNode(Entity(entity, m_Context.get()));
+			}
+
+			// Dropping an entity on the empty part of the window makes it a root.
+			ImGui::Dummy(ImMax(ImGui::GetContentRegionAvail(), ImVec2(1.0f, 1.0f)));
+			if (ImGui::BeginDragDropTarget())
+			{
+				if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("SCENE_HIERARCHY_ENTITY"))
+					m_Context->SetParent(Entity(*(const entt::entity*)payload->Data, m_Context.get()), {});
+
+				ImGui::EndDragDropTarget();
 			}
 
 			if (ImGui::IsMouseDown(ImGuiMouseButton_Left) && ImGui::IsWindowHovered())
@@ -60,14 +72,38 @@ namespace Sora {
 	void SceneHierarchyPanel::DrawEntityNode(Entity entity)
 	{
 		auto& tag = entity.GetComponent<TagComponent>().Tag;
+		// Copied, deleting or reparenting from within the node edits the list.
+		std::vector<UUID> children = entity.GetComponent<RelationshipComponent>().Children;
 
 		ImGuiTreeNodeFlags flags = ((m_SelectionContext == entity) ? ImGuiTreeNodeFlags_Selected : 0) 
 			| ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth ;
+		if (children.empty())
+			flags |= ImGuiTreeNodeFlags_Leaf;
 		bool opened = ImGui::TreeNodeEx((void*)(uint64_t)(uint32_t)entity, flags, tag.c_str());
 		
 		if (ImGui::IsItemClicked())
 			m_SelectionContext = entity;
 
+		// Drag an entity onto another to make it its child.
+		if (ImGui::BeginDragDropSource())
+		{
+			entt::entity handle = entity;
+			ImGui::SetDragDropPayload("SCENE_HIERARCHY_ENTITY", &handle, sizeof(entt::entity));
+			ImGui::Text(tag.c_str());
+			ImGui::EndDragDropSource();
+		}
+		if (ImGui::BeginDragDropTarget())
+		{
+			if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("SCENE_HIERARCHY_ENTITY"))
+			{
+				Entity child(*(const entt::entity*)payload->Data, m_Context.get());
+				if (!m_Context->SetParent(child, entity))
+					SORA_CORE_WARN("Cannot make '{0}' a child of its own descendant '{1}'", child.GetName(), tag);
+			}
+
+			ImGui::EndDragDropTarget();
+		}
+
 		bool entityDeleted = false;
 		if (ImGui::BeginPopupContextItem())
 		{
@@ -83,13 +119,19 @@ namespace Sora {
 		
 		if (opened)
 		{
+			for (UUID child : children)
+			{
+				if (Entity childEntity = m_Context->GetEntityByUUID(child))
+					DrawEntityNode(childEntity);
+			}
 			ImGui::TreePop();
 		}
 
 		if (entityDeleted)
 		{
+			// Takes the children with it, the selection may be one of them.
 			m_Context->DestroyEntity(entity);
-			if (m_SelectionContext == entity)
+			if (m_SelectionContext && !m_Context->IsValid(m_SelectionContext))
 				m_SelectionContext = {};
 		}
 	}
@@ -433,13 +475,15 @@ namespace Sora {
 					{
 						const wchar_t* path = (const wchar_t*)payload->Data;
 						const std::filesystem::path texturePath = gAssetPath / path;
-						component.Texture = Texture2D::Create(texturePath.string());
+						component.Texture = Texture2D::CreateAsync(texturePath.string());
 					}
 
 					ImGui::EndDragDropTarget();
 				}
 
 				ImGui::DragFloat("Tiling Factor", &component.TilingFactor, 0.1f, 0.0f, 100.0f);
+				ImGui::DragInt("Layer", &component.Layer, 0.1f, -128, 127);
+				ImGui::Checkbox("Static", &component.Static);
 			});
 
 		DrawComponent<CircleRendererComponent>("Circle Renderer", entity, [](auto& component)
@@ -447,6 +491,7 @@ namespace Sora {
 				ImGui::ColorEdit4("Color", glm::value_ptr(component.Color));
 				ImGui::DragFloat("Thickness", &component.Thickness, 0.025f, 0.0f, 1.0f);
 				ImGui::DragFloat("Fade", &component.Fade, 0.00025f, 0.0f, 1.0f);
+				ImGui::DragInt("Layer", &component.Layer, 0.1f, -128, 127);
 			});
 
 		DrawComponent<Rigidbody2DComponent>("Rigidbody 2D", entity, [](auto& component)